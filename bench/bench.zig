@@ -0,0 +1,688 @@
+const std = @import("std");
+const zigMLX = @import("zigMLX");
+
+const Array = zigMLX.Array;
+const ops = zigMLX.ops;
+const memory = zigMLX.memory;
+
+const warmup_iterations = 1_000;
+const ffi_iterations = 100_000;
+
+/// One benchmark measurement. Optional fields only apply to some groups and
+/// are omitted from the JSON output when unset.
+const Result = struct {
+    group: []const u8,
+    name: []const u8,
+    iterations: usize,
+    ns_per_op: f64,
+    size_bytes: ?usize = null,
+    gb_per_s: ?f64 = null,
+    depth: ?usize = null,
+    alloc_bytes_per_op: ?f64 = null,
+    n: ?usize = null,
+    gflop_per_s: ?f64 = null,
+};
+
+/// Runs `f(ctx)` `iterations` times after a warmup and returns ns per call.
+fn timeIt(iterations: usize, ctx: anytype, comptime f: anytype) !f64 {
+    for (0..@min(iterations, warmup_iterations)) |_| try f(ctx);
+    var timer = try std.time.Timer.start();
+    for (0..iterations) |_| try f(ctx);
+    return @as(f64, @floatFromInt(timer.read())) / @as(f64, @floatFromInt(iterations));
+}
+
+const FfiCase = struct {
+    name: []const u8,
+    run: *const fn (Array) anyerror!void,
+};
+
+fn checked(v: zigMLX.mlx_err) !void {
+    return zigMLX.MLX_CHECK(v, @src());
+}
+
+/// Handles and buffers shared by the `ffi_cases` that need more than the
+/// input array; set up by `benchFfi`.
+const FfiState = struct {
+    var scratch: zigMLX.mlx_array = null;
+    var key: zigMLX.mlx_array = null;
+    /// Evaluated one-element array, for `item`.
+    var scalar: zigMLX.mlx_array = null;
+    /// Unevaluated `x + x`, for the graph queries.
+    var node: zigMLX.mlx_array = null;
+    var iter: zigMLX.mlx_array_iterator = null;
+    var buf: [32 * 32]f32 = undefined;
+};
+
+/// Handle-returning op of one array, for the `ffi_cases` below; the result is
+/// destroyed right away.
+fn unaryCase(comptime op: anytype, comptime args: anytype) *const fn (Array) anyerror!void {
+    return struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(@call(.auto, op, .{ &res, a.handle } ++ args));
+            zigMLX.destroyArray(res);
+        }
+    }.f;
+}
+
+/// Handle-returning op of `a` with itself.
+fn binaryCase(comptime op: anytype) *const fn (Array) anyerror!void {
+    return struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(op(&res, a.handle, a.handle));
+            zigMLX.destroyArray(res);
+        }
+    }.f;
+}
+
+const half = zigMLX.mlx_scalar{ .kind = zigMLX.mlx_scalar_float, .val = .{ .f = 0.5 } };
+const shape_32x32 = [_]c_int{ 32, 32 };
+const shape_1024 = [_]c_int{1024};
+const axes_10 = [_]c_int{ 1, 0 };
+const axis_0 = [_]c_int{0};
+const start_00 = [_]c_int{ 0, 0 };
+const stop_16 = [_]c_int{ 16, 16 };
+const strides_11 = [_]c_int{ 1, 1 };
+const shape_4x32x32 = [_]c_int{ 4, 32, 32 };
+const elem_strides = [_]i64{ 32, 1 };
+
+/// Per-call latency of the bindings on the hot path of array code: metadata
+/// and graph queries, handle creation, iteration, elementwise ops (plain,
+/// scalar, `*_into`), views, export, random, matmul and quantization.
+/// Bindings returning a handle also pay for `destroyArray`. Whole-graph, I/O
+/// and compile bindings are covered by the other groups or not at all.
+const ffi_cases = [_]FfiCase{
+    .{ .name = "itemsize", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.itemsize(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "size", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.size(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "nbytes", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.nbytes(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "ndim", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.ndim(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "shape", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: ?*anyopaque = null;
+            try checked(zigMLX.shape(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "dim", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: c_int = undefined;
+            try checked(zigMLX.dim(&res, 0, a.handle));
+        }
+    }.f },
+    .{ .name = "strides", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: ?*anyopaque = null;
+            var len: usize = undefined;
+            try checked(zigMLX.strides(&res, &len, a.handle));
+        }
+    }.f },
+    .{ .name = "dtype", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_dtype = undefined;
+            try checked(zigMLX.dtype(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "describe", .run = struct {
+        fn f(a: Array) anyerror!void {
+            _ = try a.describe();
+        }
+    }.f },
+    .{ .name = "id", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.id(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "has_primitive", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: bool = undefined;
+            try checked(zigMLX.has_primitive(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "flags", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array_flags = undefined;
+            try checked(zigMLX.flags(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "data_size", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.data_size(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "data", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: ?*anyopaque = null;
+            try checked(zigMLX.data(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "is_evaled", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: bool = undefined;
+            try checked(zigMLX.is_evaled(&res, a.handle));
+        }
+    }.f },
+    .{ .name = "eval_array", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.eval_array(true, a.handle));
+        }
+    }.f },
+    .{ .name = "item", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: f32 = undefined;
+            try checked(zigMLX.item(&res, false, FfiState.scalar));
+        }
+    }.f },
+    .{ .name = "primitive", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_primitive = null;
+            try checked(zigMLX.primitive(&res, FfiState.node));
+        }
+    }.f },
+    .{ .name = "num_inputs", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: usize = undefined;
+            try checked(zigMLX.num_inputs(&res, FfiState.node));
+        }
+    }.f },
+    .{ .name = "inputs", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: [2]zigMLX.mlx_array = .{ null, null };
+            try checked(zigMLX.inputs(&res, res.len, FfiState.node));
+            for (res) |r| zigMLX.destroyArray(r);
+        }
+    }.f },
+    .{ .name = "detach", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.detach(a.handle));
+        }
+    }.f },
+    .{ .name = "set_tracer", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.set_tracer(false, a.handle));
+        }
+    }.f },
+    .{ .name = "begin", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array_iterator = null;
+            try checked(zigMLX.begin(&res, a.handle));
+            zigMLX.destroyArrayIterator(res);
+        }
+    }.f },
+    .{ .name = "next", .run = struct {
+        fn f(_: Array) anyerror!void {
+            try checked(zigMLX.next(FfiState.iter));
+        }
+    }.f },
+    .{ .name = "nextDiff", .run = struct {
+        fn f(_: Array) anyerror!void {
+            try checked(zigMLX.nextDiff(FfiState.iter, 1));
+        }
+    }.f },
+    .{ .name = "arrayIterEql", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: bool = undefined;
+            try checked(zigMLX.arrayIterEql(&res, FfiState.iter, FfiState.iter));
+        }
+    }.f },
+    .{ .name = "cloneHandle", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.cloneHandle(&res, a.handle));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "fromScalar", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.fromScalar(&res, 0.5, zigMLX.float32));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "fromScalarI64", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.fromScalarI64(&res, 1));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "fromScalarU64", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.fromScalarU64(&res, 1));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "initHandle", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.initHandle(&res, &shape_32x32, shape_32x32.len, zigMLX.float32));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "initEmpty", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.initEmpty(&res));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "add", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.add(&res, a.handle, a.handle));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "multiply_scalar", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.multiply_scalar(&res, a.handle, half, zigMLX.mlx_rhs));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "subtract", .run = binaryCase(zigMLX.subtract) },
+    .{ .name = "multiply", .run = binaryCase(zigMLX.multiply) },
+    .{ .name = "divide", .run = binaryCase(zigMLX.divide) },
+    .{ .name = "add_scalar", .run = unaryCase(zigMLX.add_scalar, .{ half, zigMLX.mlx_rhs }) },
+    .{ .name = "subtract_scalar", .run = unaryCase(zigMLX.subtract_scalar, .{ half, zigMLX.mlx_rhs }) },
+    .{ .name = "divide_scalar", .run = unaryCase(zigMLX.divide_scalar, .{ half, zigMLX.mlx_rhs }) },
+    .{ .name = "add_into", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.add_into(FfiState.scratch, a.handle, a.handle));
+        }
+    }.f },
+    .{ .name = "multiply_scalar_into", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.multiply_scalar_into(FfiState.scratch, a.handle, half, zigMLX.mlx_rhs));
+        }
+    }.f },
+    .{ .name = "slice", .run = unaryCase(zigMLX.slice, .{ &start_00, &stop_16, &strides_11, start_00.len }) },
+    .{ .name = "reshape", .run = unaryCase(zigMLX.reshape, .{ &shape_1024, shape_1024.len }) },
+    .{ .name = "transpose", .run = unaryCase(zigMLX.transpose, .{ &axes_10, axes_10.len }) },
+    .{ .name = "expand_dims", .run = unaryCase(zigMLX.expand_dims, .{ &axis_0, axis_0.len }) },
+    .{ .name = "squeeze", .run = unaryCase(zigMLX.squeeze, .{ @as(?*const c_int, null), 0 }) },
+    .{ .name = "broadcast_to", .run = unaryCase(zigMLX.broadcast_to, .{ &shape_4x32x32, shape_4x32x32.len }) },
+    .{ .name = "as_strided", .run = unaryCase(zigMLX.as_strided, .{ &shape_32x32, &elem_strides, shape_32x32.len, 0 }) },
+    .{ .name = "copy_to", .run = struct {
+        fn f(a: Array) anyerror!void {
+            try checked(zigMLX.copy_to(a.handle, &FfiState.buf, zigMLX.float32, zigMLX.mlx_row_major));
+        }
+    }.f },
+    .{ .name = "seed", .run = struct {
+        fn f(_: Array) anyerror!void {
+            try checked(zigMLX.seed(0));
+        }
+    }.f },
+    .{ .name = "randomNormal", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.randomNormal(&res, &shape_32x32, shape_32x32.len, zigMLX.float32));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "randomKey", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.randomKey(&res, 0));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "randomSplit", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: [2]zigMLX.mlx_array = .{ null, null };
+            try checked(zigMLX.randomSplit(&res, res.len, FfiState.key));
+            for (res) |r| zigMLX.destroyArray(r);
+        }
+    }.f },
+    .{ .name = "randomNormalKey", .run = struct {
+        fn f(_: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.randomNormalKey(&res, &shape_32x32, shape_32x32.len, zigMLX.float32, 0, 1, FfiState.key));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "matmul", .run = binaryCase(zigMLX.matmul) },
+    .{ .name = "addmm", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.addmm(&res, a.handle, a.handle, a.handle, 1, 1));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "linear", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: zigMLX.mlx_array = null;
+            try checked(zigMLX.linear(&res, a.handle, a.handle, null));
+            zigMLX.destroyArray(res);
+        }
+    }.f },
+    .{ .name = "quantize", .run = struct {
+        fn f(a: Array) anyerror!void {
+            var res: [3]zigMLX.mlx_array = .{ null, null, null };
+            try checked(zigMLX.quantize(&res[0], &res[1], &res[2], a.handle, 32, 4));
+            for (res) |r| zigMLX.destroyArray(r);
+        }
+    }.f },
+};
+
+const FfiCtx = struct {
+    run: *const fn (Array) anyerror!void,
+    x: Array,
+
+    fn call(self: FfiCtx) !void {
+        return self.run(self.x);
+    }
+};
+
+fn benchFfi(results: *std.ArrayList(Result)) !void {
+    var x = try Array.randomNormal(&.{ 32, 32 }, zigMLX.float32);
+    defer x.deinit();
+    try x.eval(false);
+    try checked(zigMLX.cloneHandle(&FfiState.scratch, x.handle));
+    defer zigMLX.destroyArray(FfiState.scratch);
+    try checked(zigMLX.randomKey(&FfiState.key, 0));
+    defer zigMLX.destroyArray(FfiState.key);
+    try checked(zigMLX.fromScalar(&FfiState.scalar, 0.5, zigMLX.float32));
+    defer zigMLX.destroyArray(FfiState.scalar);
+    try checked(zigMLX.eval_array(false, FfiState.scalar));
+    try checked(zigMLX.add(&FfiState.node, x.handle, x.handle));
+    defer zigMLX.destroyArray(FfiState.node);
+    try checked(zigMLX.begin(&FfiState.iter, x.handle));
+    defer zigMLX.destroyArrayIterator(FfiState.iter);
+    for (ffi_cases) |case| {
+        const ctx = FfiCtx{ .run = case.run, .x = x };
+        try results.append(.{
+            .group = "ffi_latency",
+            .name = case.name,
+            .iterations = ffi_iterations,
+            .ns_per_op = try timeIt(ffi_iterations, ctx, FfiCtx.call),
+        });
+    }
+}
+
+const CopyCtx = struct {
+    buf: []f32,
+    no_copy: bool,
+
+    fn call(self: CopyCtx) !void {
+        const shape = [_]c_int{@intCast(self.buf.len)};
+        var res: zigMLX.mlx_array = null;
+        if (self.no_copy) {
+            try checked(zigMLX.fromPtrNoCopy(&res, self.buf.ptr, &shape, shape.len, zigMLX.float32, null, null));
+        } else {
+            try checked(zigMLX.fromPtr(&res, self.buf.ptr, &shape, shape.len, zigMLX.float32));
+        }
+        zigMLX.destroyArray(res);
+    }
+};
+
+/// Ingest bandwidth of the copying `fromPtr` against `fromPtrNoCopy`.
+fn benchFromPtr(allocator: std.mem.Allocator, results: *std.ArrayList(Result)) !void {
+    const sizes = [_]usize{ 4 << 10, 64 << 10, 1 << 20, 16 << 20, 64 << 20 };
+    for (sizes) |size_bytes| {
+        const buf = try allocator.alloc(f32, size_bytes / @sizeOf(f32));
+        defer allocator.free(buf);
+        @memset(buf, 1);
+        const iterations = @max(8, (256 << 20) / size_bytes);
+        for ([_]bool{ false, true }) |no_copy| {
+            const ns = try timeIt(iterations, CopyCtx{ .buf = buf, .no_copy = no_copy }, CopyCtx.call);
+            try results.append(.{
+                .group = "from_ptr",
+                .name = if (no_copy) "fromPtrNoCopy" else "fromPtr",
+                .iterations = iterations,
+                .ns_per_op = ns,
+                .size_bytes = size_bytes,
+                .gb_per_s = @as(f64, @floatFromInt(size_bytes)) / ns,
+            });
+        }
+    }
+}
+
+/// Scalar operand materialized as its own array before the op, i.e. the
+/// path `ops` took before the `*_scalar` bindings existed.
+fn scalarViaArray(x: Array) !void {
+    var s = try Array.fromScalar(0.5, try x.dtype());
+    defer s.deinit();
+    var r = try ops.multiply(Array, x, Array, s);
+    r.deinit();
+}
+
+/// Scalar operand handed to the `*_scalar` bindings.
+fn scalarFastPath(x: Array) !void {
+    var r = try ops.multiply(Array, x, f32, 0.5);
+    r.deinit();
+}
+
+fn arrayOperand(x: Array) !void {
+    var r = try ops.multiply(Array, x, Array, x);
+    r.deinit();
+}
+
+fn benchScalarOps(results: *std.ArrayList(Result)) !void {
+    var x = try Array.randomNormal(&.{1024}, zigMLX.float32);
+    defer x.deinit();
+    try results.append(.{ .group = "scalar_ops", .name = "scalar_via_temporary_array", .iterations = ffi_iterations, .ns_per_op = try timeIt(ffi_iterations, x, scalarViaArray) });
+    try results.append(.{ .group = "scalar_ops", .name = "scalar_binding", .iterations = ffi_iterations, .ns_per_op = try timeIt(ffi_iterations, x, scalarFastPath) });
+    try results.append(.{ .group = "scalar_ops", .name = "array_operand", .iterations = ffi_iterations, .ns_per_op = try timeIt(ffi_iterations, x, arrayOperand) });
+}
+
+const DepthCtx = struct {
+    x: Array,
+    depth: usize,
+
+    /// Builds a chain of `depth` adds on `x` and evaluates it.
+    fn call(self: DepthCtx) !void {
+        var y = try ops.add(Array, self.x, f32, 1);
+        for (1..self.depth) |_| {
+            const next = try ops.add(Array, y, f32, 1);
+            y.deinit();
+            y = next;
+        }
+        defer y.deinit();
+        try y.eval(false);
+    }
+};
+
+fn benchEvalDepth(results: *std.ArrayList(Result)) !void {
+    var x = try Array.randomNormal(&.{1024}, zigMLX.float32);
+    defer x.deinit();
+    try x.eval(false);
+    for ([_]usize{ 1, 4, 16, 64, 256 }) |depth| {
+        const iterations = 20_000 / depth;
+        try results.append(.{
+            .group = "eval_depth",
+            .name = "add_chain",
+            .iterations = iterations,
+            .ns_per_op = try timeIt(iterations, DepthCtx{ .x = x, .depth = depth }, DepthCtx.call),
+            .depth = depth,
+        });
+    }
+}
+
+const GemmKind = enum { matmul, batched_matmul, linear };
+
+const GemmCtx = struct {
+    kind: GemmKind,
+    x: Array,
+    w: Array,
+    b: Array,
+
+    /// Issues one product of `x` and `w` and evaluates it.
+    fn call(self: GemmCtx) !void {
+        var y = switch (self.kind) {
+            .matmul, .batched_matmul => try ops.matmul(self.x, self.w),
+            .linear => try ops.linear(self.x, self.w, self.b),
+        };
+        defer y.deinit();
+        try y.eval(false);
+    }
+};
+
+/// Throughput of `[batch, n, n] @ [n, n]` products; `linear` also adds a bias
+/// and reads the weight transposed.
+fn benchMatmul(results: *std.ArrayList(Result)) !void {
+    const batch = 8;
+    for ([_]usize{ 128, 256, 512, 1024 }) |n| {
+        const dim: i64 = @intCast(n);
+        var w = try Array.randomNormal(&.{ dim, dim }, zigMLX.float32);
+        defer w.deinit();
+        var b = try Array.randomNormal(&.{dim}, zigMLX.float32);
+        defer b.deinit();
+        var x = try Array.randomNormal(&.{ dim, dim }, zigMLX.float32);
+        defer x.deinit();
+        var xb = try Array.randomNormal(&.{ batch, dim, dim }, zigMLX.float32);
+        defer xb.deinit();
+        for ([_]*Array{ &w, &b, &x, &xb }) |arr| try arr.eval(false);
+
+        for ([_]GemmKind{ .matmul, .batched_matmul, .linear }) |kind| {
+            const rows: usize = if (kind == .batched_matmul) batch * n else n;
+            const flop = 2 * @as(f64, @floatFromInt(rows * n * n));
+            const iterations = @max(4, @as(usize, @intFromFloat((1 << 32) / flop)));
+            const ctx = GemmCtx{ .kind = kind, .x = if (kind == .batched_matmul) xb else x, .w = w, .b = b };
+            const ns = try timeIt(iterations, ctx, GemmCtx.call);
+            try results.append(.{
+                .group = "matmul",
+                .name = @tagName(kind),
+                .iterations = iterations,
+                .ns_per_op = ns,
+                .n = n,
+                .gflop_per_s = flop / ns,
+            });
+        }
+    }
+}
+
+const batch_len = 256;
+
+const BatchCtx = struct {
+    x: Array,
+    descs: []const ops.OpDesc,
+    allocator: std.mem.Allocator,
+
+    /// Issues a chain of `batch_len` scalar adds as separate binding calls.
+    fn individual(self: BatchCtx) !void {
+        var results: [batch_len]Array = undefined;
+        results[0] = try ops.add(Array, self.x, f32, 1);
+        for (1..batch_len) |i| results[i] = try ops.add(Array, results[i - 1], f32, 1);
+        for (&results) |*r| r.deinit();
+    }
+
+    /// Issues the same chain through a single `dispatchBatch` call.
+    fn batched(self: BatchCtx) !void {
+        const results = try ops.dispatchBatch(self.allocator, self.descs, false);
+        Array.deinitSlice(self.allocator, results);
+    }
+};
+
+fn benchBatchDispatch(allocator: std.mem.Allocator, results: *std.ArrayList(Result)) !void {
+    var x = try Array.randomNormal(&.{16}, zigMLX.float32);
+    defer x.deinit();
+    try x.eval(false);
+    var descs: [batch_len]ops.OpDesc = undefined;
+    descs[0] = .{ .op = .add, .lhs = .{ .array = x }, .rhs = .{ .float = 1 } };
+    for (1..batch_len) |i| descs[i] = .{ .op = .add, .lhs = .{ .result = i - 1 }, .rhs = .{ .float = 1 } };
+    const ctx = BatchCtx{ .x = x, .descs = &descs, .allocator = allocator };
+    const iterations = 1_000;
+    try results.append(.{ .group = "batch_dispatch", .name = "individual_calls", .iterations = iterations * batch_len, .ns_per_op = try timeIt(iterations, ctx, BatchCtx.individual) / batch_len });
+    try results.append(.{ .group = "batch_dispatch", .name = "dispatch_batch", .iterations = iterations * batch_len, .ns_per_op = try timeIt(iterations, ctx, BatchCtx.batched) / batch_len });
+}
+
+const AllocCase = struct {
+    name: []const u8,
+    make: *const fn (Array) anyerror!Array,
+};
+
+const alloc_cases = [_]AllocCase{
+    .{ .name = "add", .make = struct {
+        fn f(x: Array) anyerror!Array {
+            return ops.add(Array, x, Array, x);
+        }
+    }.f },
+    .{ .name = "multiply_scalar", .make = struct {
+        fn f(x: Array) anyerror!Array {
+            return ops.multiply(Array, x, f32, 0.5);
+        }
+    }.f },
+    .{ .name = "fromScalar", .make = struct {
+        fn f(_: Array) anyerror!Array {
+            return Array.fromScalar(0.5, zigMLX.float32);
+        }
+    }.f },
+    .{ .name = "randomNormal", .make = struct {
+        fn f(_: Array) anyerror!Array {
+            return Array.randomNormal(&.{1024}, zigMLX.float32);
+        }
+    }.f },
+};
+
+/// Bytes MLX's allocator holds per evaluated op result. MLX does not expose
+/// allocation counts, so this tracks the growth of active memory while the
+/// results are kept alive.
+fn benchAllocations(allocator: std.mem.Allocator, results: *std.ArrayList(Result)) !void {
+    const n = 256;
+    var x = try Array.randomNormal(&.{1024}, zigMLX.float32);
+    defer x.deinit();
+    try x.eval(false);
+    const outs = try allocator.alloc(Array, n);
+    defer allocator.free(outs);
+    for (alloc_cases) |case| {
+        const before = try memory.activeMemory();
+        var timer = try std.time.Timer.start();
+        for (outs) |*out| out.* = try case.make(x);
+        try Array.evalMany(outs);
+        const elapsed = timer.read();
+        const after = try memory.activeMemory();
+        for (outs) |*out| out.deinit();
+        try results.append(.{
+            .group = "allocations",
+            .name = case.name,
+            .iterations = n,
+            .ns_per_op = @as(f64, @floatFromInt(elapsed)) / n,
+            .alloc_bytes_per_op = @as(f64, @floatFromInt(after -| before)) / n,
+        });
+    }
+}
+
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    try zigMLX.MLX_CHECK(zigMLX.seed(0), @src());
+
+    var results = std.ArrayList(Result).init(allocator);
+    defer results.deinit();
+    try benchFfi(&results);
+    try benchFromPtr(std.heap.page_allocator, &results);
+    try benchScalarOps(&results);
+    try benchEvalDepth(&results);
+    try benchAllocations(allocator, &results);
+    try benchBatchDispatch(allocator, &results);
+    try benchMatmul(&results);
+
+    const stdout = std.io.getStdOut().writer();
+    try std.json.stringify(.{ .results = results.items }, .{ .emit_null_optional_fields = false }, stdout);
+    try stdout.writeByte('\n');
+}
@@ -0,0 +1,160 @@
+const std = @import("std");
+const zigMLX = @import("zigMLX");
+
+const Array = zigMLX.Array;
+const ops = zigMLX.ops;
+
+const ops_per_thread = 20_000;
+/// Ops chained before each eval.
+const chain_len = 16;
+const elems = 4096;
+
+/// One measurement: `workload` run on `threads` threads concurrently.
+const Result = struct {
+    workload: []const u8,
+    threads: usize,
+    ops: usize,
+    ns: u64,
+    ops_per_s: f64,
+    /// Throughput relative to the single-threaded run of the same workload.
+    speedup: f64,
+};
+
+const Shared = struct {
+    /// Evaluated input read by every thread.
+    weights: Array,
+    /// Unevaluated subgraph every thread's graph depends on; the first evals
+    /// race to compute it.
+    lazy: Array,
+};
+
+const Workload = struct {
+    name: []const u8,
+    run: *const fn (shared: *const Shared, key: Array) anyerror!void,
+};
+
+/// Chains `chain_len` ops on `x` starting from `start`, evaluates and checks
+/// the result is finite.
+fn chain(start: Array, operand: Array) !void {
+    var y = try ops.add(Array, start, Array, operand);
+    for (1..chain_len) |_| {
+        const next = try ops.multiply(Array, y, f32, 0.5);
+        y.deinit();
+        y = next;
+    }
+    defer y.deinit();
+    try y.eval(false);
+    const first = (try y.data(f32))[0];
+    if (!std.math.isFinite(first)) return error.CorruptResult;
+}
+
+const workloads = [_]Workload{
+    .{ .name = "disjoint", .run = struct {
+        fn f(_: *const Shared, key: Array) anyerror!void {
+            var x = try Array.randomUniform(0, 1, &.{elems}, zigMLX.float32, key);
+            defer x.deinit();
+            try x.eval(false);
+            for (0..ops_per_thread / chain_len) |_| try chain(x, x);
+        }
+    }.f },
+    .{ .name = "shared_inputs", .run = struct {
+        fn f(shared: *const Shared, key: Array) anyerror!void {
+            var x = try Array.randomUniform(0, 1, &.{elems}, zigMLX.float32, key);
+            defer x.deinit();
+            try x.eval(false);
+            for (0..ops_per_thread / chain_len) |_| try chain(x, shared.weights);
+        }
+    }.f },
+    .{ .name = "shared_subgraph", .run = struct {
+        fn f(shared: *const Shared, key: Array) anyerror!void {
+            var x = try Array.randomUniform(0, 1, &.{elems}, zigMLX.float32, key);
+            defer x.deinit();
+            try x.eval(false);
+            for (0..ops_per_thread / chain_len) |_| try chain(x, shared.lazy);
+        }
+    }.f },
+};
+
+fn worker(workload: Workload, shared: *const Shared, key: Array, failed: *std.atomic.Atomic(bool)) void {
+    workload.run(shared, key) catch {
+        failed.store(true, .Monotonic);
+    };
+}
+
+/// Runs `workload` on `n_threads` threads, each with its own PRNG key, and
+/// returns the wall time in ns.
+fn runThreads(allocator: std.mem.Allocator, workload: Workload, n_threads: usize) !u64 {
+    var root = try Array.randomKey(n_threads);
+    defer root.deinit();
+    const keys = try root.splitKey(allocator, n_threads);
+    defer Array.deinitSlice(allocator, keys);
+
+    var weights = try Array.randomNormalKey(&.{elems}, zigMLX.float32, 0, 1, keys[0]);
+    defer weights.deinit();
+    try weights.eval(false);
+    var lazy = try ops.multiply(Array, weights, f32, 2);
+    defer lazy.deinit();
+    const shared = Shared{ .weights = weights, .lazy = lazy };
+
+    const threads = try allocator.alloc(std.Thread, n_threads);
+    defer allocator.free(threads);
+    var failed = std.atomic.Atomic(bool).init(false);
+    var timer = try std.time.Timer.start();
+    for (threads, keys) |*t, key| {
+        t.* = try std.Thread.spawn(.{}, worker, .{ workload, &shared, key, &failed });
+    }
+    for (threads) |t| t.join();
+    const elapsed = timer.read();
+    if (failed.load(.Monotonic)) return error.WorkerFailed;
+    return elapsed;
+}
+
+/// Thread counts to measure: powers of two up to `max_threads`, plus
+/// `max_threads` itself.
+fn threadCounts(allocator: std.mem.Allocator, max_threads: usize) ![]usize {
+    var res = std.ArrayList(usize).init(allocator);
+    errdefer res.deinit();
+    var n: usize = 1;
+    while (n < max_threads) : (n *= 2) try res.append(n);
+    try res.append(max_threads);
+    return res.toOwnedSlice();
+}
+
+/// Usage: `zig build stress -Doptimize=ReleaseFast [-- max_threads]`
+/// (defaults to the number of CPUs).
+pub fn main() !void {
+    var gpa = std.heap.GeneralPurposeAllocator(.{}){};
+    defer _ = gpa.deinit();
+    const allocator = gpa.allocator();
+
+    const args = try std.process.argsAlloc(allocator);
+    defer std.process.argsFree(allocator, args);
+    const max_threads = if (args.len > 1) try std.fmt.parseInt(usize, args[1], 10) else try std.Thread.getCpuCount();
+    if (max_threads == 0) return error.InvalidThreadCount;
+    const counts = try threadCounts(allocator, max_threads);
+    defer allocator.free(counts);
+
+    var results = std.ArrayList(Result).init(allocator);
+    defer results.deinit();
+    for (workloads) |workload| {
+        var base_ops_per_s: f64 = 0;
+        for (counts) |n_threads| {
+            const ns = try runThreads(allocator, workload, n_threads);
+            const total_ops = n_threads * ops_per_thread;
+            const ops_per_s = @as(f64, @floatFromInt(total_ops)) * std.time.ns_per_s / @as(f64, @floatFromInt(ns));
+            if (n_threads == 1) base_ops_per_s = ops_per_s;
+            try results.append(.{
+                .workload = workload.name,
+                .threads = n_threads,
+                .ops = total_ops,
+                .ns = ns,
+                .ops_per_s = ops_per_s,
+                .speedup = ops_per_s / base_ops_per_s,
+            });
+        }
+    }
+
+    const stdout = std.io.getStdOut().writer();
+    try std.json.stringify(.{ .results = results.items }, .{}, stdout);
+    try stdout.writeByte('\n');
+}
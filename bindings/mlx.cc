@@ -1,192 +1,2111 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <exception>
-#include <iostream>
+#include <fcntl.h>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <numeric>
+#include <optional>
 #include <stdlib.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
 
+#include "mlx/compile_impl.h"
 #include "mlx/mlx.h"
 #include "mlx_types.h"
 
 using namespace mlx::core;
 
-mlx_err handle_eptr(std::exception_ptr eptr) {
+// Last failure on the calling thread. Recorded into fixed storage so error
+// paths neither allocate nor contend on a shared stream.
+struct ErrorRecord {
+  mlx_err code = mlx_err::mlx_success;
+  const char *op = "";
+  char message[512] = {};
+};
+
+thread_local ErrorRecord last_error;
+
+mlx_err recordError(mlx_err code, const char *op, const char *what) {
+  last_error.code = code;
+  last_error.op = op;
+  std::strncpy(last_error.message, what, sizeof(last_error.message) - 1);
+  last_error.message[sizeof(last_error.message) - 1] = '\0';
+  return code;
+}
+
+// Unwinds past MLX after a failure that is already recorded as the thread's
+// last error (e.g. by a binding called from a compiled function), so the
+// original record reaches the caller.
+struct RecordedError : std::exception {
+  const char *what() const noexcept override { return last_error.message; }
+};
+
+// Classifies the in-flight exception and records it as the thread's last
+// error. Must be called from within a `catch` block.
+mlx_err handle_exception(const char *op) {
+  try {
+    throw;
+  } catch (const RecordedError &) {
+    return last_error.code;
+  } catch (const std::invalid_argument &e) {
+    return recordError(mlx_err::mlx_invalid_argument, op, e.what());
+  } catch (const std::out_of_range &e) {
+    return recordError(mlx_err::mlx_out_of_range, op, e.what());
+  } catch (const std::bad_alloc &e) {
+    return recordError(mlx_err::mlx_out_of_memory, op, e.what());
+  } catch (const std::runtime_error &e) {
+    return recordError(mlx_err::mlx_runtime_error, op, e.what());
+  } catch (const std::exception &e) {
+    return recordError(mlx_err::mlx_exception, op, e.what());
+  } catch (...) {
+    return recordError(mlx_err::mlx_unknown_error, op, "Unknown exception");
+  }
+}
+
+// Opt-in profiling. Every binding opens a `ProfileScope`; while profiling is
+// disabled that is a single relaxed atomic load, so it stays compiled in.
+std::atomic<bool> profiling_enabled{false};
+
+using ProfileClock = std::chrono::steady_clock;
+
+struct TraceEvent {
+  const char *op;
+  int64_t start_ns;
+  int64_t dur_ns;
+  size_t tid;
+  size_t bytes;
+  size_t graph_nodes;
+};
+
+class Profiler {
+ public:
+  void record(const char *op, ProfileClock::time_point start,
+              ProfileClock::time_point end, size_t bytes, size_t graph_nodes) {
+    static std::atomic<size_t> next_tid{0};
+    thread_local size_t tid = next_tid++;
+    int64_t dur = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      end - start)
+                      .count();
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(op);
+    if (it == index_.end()) {
+      it = index_.emplace(op, stats_.size()).first;
+      stats_.push_back({op, 0, 0, 0, 0, 0});
+    }
+    auto &stat = stats_[it->second];
+    ++stat.calls;
+    stat.total_ns += dur;
+    stat.max_ns = std::max<uint64_t>(stat.max_ns, dur);
+    stat.bytes_allocated += bytes;
+    stat.graph_nodes += graph_nodes;
+    int64_t since_origin =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin_)
+            .count();
+    TraceEvent event{op, since_origin, dur, tid, bytes, graph_nodes};
+    if (events_.size() < kMaxTraceEvents) {
+      events_.push_back(event);
+    } else {
+      // full: overwrite the oldest event so the trace keeps the latest calls
+      events_[next_event_] = event;
+      next_event_ = (next_event_ + 1) % kMaxTraceEvents;
+      ++dropped_events_;
+    }
+  }
+
+  void reset() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.clear();
+    index_.clear();
+    events_.clear();
+    next_event_ = 0;
+    dropped_events_ = 0;
+    origin_ = ProfileClock::now();
+  }
+
+  size_t size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.size();
+  }
+
+  mlx_profile_stat stat(size_t idx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.at(idx);
+  }
+
+  // Chrome trace event format: one complete ("X") event per binding call,
+  // timestamps in microseconds since the last reset. Calls evicted from the
+  // event buffer are counted in `otherData.dropped_events`.
+  std::string traceJson() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out = "{\"traceEvents\":[";
+    char buf[128];
+    for (size_t i = 0; i < events_.size(); ++i) {
+      const auto &e = events_[(next_event_ + i) % events_.size()];
+      // op names are C identifiers, so they need no escaping
+      out += i > 0 ? ",{\"name\":\"" : "{\"name\":\"";
+      out += e.op;
+      std::snprintf(buf, sizeof(buf),
+                    "\",\"ph\":\"X\",\"pid\":0,\"tid\":%zu,\"ts\":%.3f,"
+                    "\"dur\":%.3f,",
+                    e.tid, e.start_ns / 1e3, e.dur_ns / 1e3);
+      out += buf;
+      std::snprintf(buf, sizeof(buf),
+                    "\"args\":{\"bytes\":%zu,\"graph_nodes\":%zu}}", e.bytes,
+                    e.graph_nodes);
+      out += buf;
+    }
+    std::snprintf(buf, sizeof(buf),
+                  "],\"otherData\":{\"dropped_events\":%zu}}\n",
+                  dropped_events_);
+    return out + buf;
+  }
+
+ private:
+  // Bounds trace memory (~48 bytes per event) in long profiling sessions;
+  // the aggregate stats stay exact.
+  static constexpr size_t kMaxTraceEvents = size_t{1} << 20;
+
+  std::mutex mutex_;
+  std::vector<mlx_profile_stat> stats_;
+  std::unordered_map<const char *, size_t> index_;
+  std::vector<TraceEvent> events_;
+  size_t next_event_ = 0;
+  size_t dropped_events_ = 0;
+  ProfileClock::time_point origin_ = ProfileClock::now();
+};
+
+// Intentionally leaked so bindings called during static destruction can
+// still record.
+Profiler &profiler() {
+  static auto *p = new Profiler();
+  return *p;
+}
+
+// Records the enclosing binding call. `op` must have static storage duration
+// (bindings pass `__func__`); bytes allocated are the growth in MLX's active
+// memory over the call, so work from other threads can be attributed to it.
+class ProfileScope {
+ public:
+  explicit ProfileScope(const char *op)
+      : active_(profiling_enabled.load(std::memory_order_relaxed)) {
+    if (active_) {
+      op_ = op;
+      memory_ = get_active_memory();
+      start_ = ProfileClock::now();
+    }
+  }
+
+  ~ProfileScope() {
+    if (!active_) {
+      return;
+    }
+    auto end = ProfileClock::now();
+    size_t memory = get_active_memory();
+    try {
+      profiler().record(op_, start_, end,
+                        memory > memory_ ? memory - memory_ : 0, graph_nodes_);
+    } catch (...) {
+      // dropping a sample must never turn into an error of the binding
+    }
+  }
+
+  ProfileScope(const ProfileScope &) = delete;
+  ProfileScope &operator=(const ProfileScope &) = delete;
+
+  bool active() const { return active_; }
+  void setGraphNodes(size_t n) { graph_nodes_ = n; }
+
+ private:
+  bool active_;
+  const char *op_ = nullptr;
+  size_t memory_ = 0;
+  size_t graph_nodes_ = 0;
+  ProfileClock::time_point start_;
+};
+
+// Unevaluated arrays an eval of `outputs` will compute.
+std::vector<array> pendingNodes(const std::vector<array> &outputs) {
+  std::unordered_map<std::uintptr_t, bool> seen;
+  std::vector<array> stack(outputs.begin(), outputs.end());
+  std::vector<array> pending;
+  while (!stack.empty()) {
+    auto a = stack.back();
+    stack.pop_back();
+    if (a.is_evaled() || !seen.emplace(a.id(), true).second) {
+      continue;
+    }
+    pending.push_back(a);
+    for (const auto &in : a.inputs()) {
+      stack.push_back(in);
+    }
+  }
+  return pending;
+}
+
+// Concurrency. Bindings may be called from any number of threads as long as
+// each handle is only mutated by one thread at a time; the shim state that
+// MLX leaves unsynchronized is guarded here.
+//
+// Scheduling a graph walks and mutates every unevaluated array in it, so two
+// evals whose graphs share unevaluated arrays must not schedule at the same
+// time. Only scheduling is serialized (retaining evals aside, see
+// `evalShared`): computation and waiting for results run outside the lock,
+// so evals over disjoint or already evaluated inputs proceed in parallel.
+std::mutex eval_mutex;
+
+// MLX detaches evaluated arrays from their inputs unless asked to retain the
+// graph. Its retaining eval computes synchronously, so `retain_graph` evals
+// run entirely under the lock: the graph they keep may be shared with another
+// thread's eval that would otherwise detach it mid-computation. When
+// `pending` is set it receives the number of nodes scheduled; the graph is
+// walked under the lock, as other threads' evals detach nodes they share.
+void evalShared(std::vector<array> outputs, bool retain_graph = false,
+                size_t *pending = nullptr) {
+  {
+    std::lock_guard<std::mutex> lock(eval_mutex);
+    if (pending != nullptr) {
+      *pending = pendingNodes(outputs).size();
+    }
+    if (retain_graph) {
+      for (auto &a : outputs) {
+        a.eval(true);
+      }
+      return;
+    }
+    mlx::core::async_eval(outputs);
+  }
+  for (auto &a : outputs) {
+    a.wait();
+  }
+}
+
+// MLX's global key sequence is unsynchronized; `seed` and random bindings
+// drawing from it (no explicit key) are serialized. Keyed calls never lock.
+std::mutex random_mutex;
+
+std::unique_lock<std::mutex> lockGlobalRandom(mlx_array key) {
+  return key == nullptr ? std::unique_lock<std::mutex>(random_mutex)
+                        : std::unique_lock<std::mutex>();
+}
+
+// Guards MLX's compile cache. Recursive because a compiled function may call
+// another compiled function while being traced.
+std::recursive_mutex compile_mutex;
+
+Dtype dtypeFromEnum(mlx_dtype dtype_enum) {
+  switch (dtype_enum) {
+  case mlx_dtype::bool_:
+    return mlx::core::bool_;
+  case mlx_dtype::uint8:
+    return mlx::core::uint8;
+  case mlx_dtype::uint16:
+    return mlx::core::uint16;
+  case mlx_dtype::uint32:
+    return mlx::core::uint32;
+  case mlx_dtype::uint64:
+    return mlx::core::uint64;
+  case mlx_dtype::int8:
+    return mlx::core::int8;
+  case mlx_dtype::int16:
+    return mlx::core::int16;
+  case mlx_dtype::int32:
+    return mlx::core::int32;
+  case mlx_dtype::int64:
+    return mlx::core::int64;
+  case mlx_dtype::float16:
+    return mlx::core::float16;
+  case mlx_dtype::float32:
+    return mlx::core::float32;
+  case mlx_dtype::bfloat16:
+    return mlx::core::bfloat16;
+  // TODO: case mlx_dtype::complex64:
+  default:
+    throw std::invalid_argument("Invalid dtype enum");
+  }
+}
+
+mlx_dtype enumFromDtype(Dtype val) {
+  switch (val) {
+  case mlx::core::bool_:
+    return mlx_dtype::bool_;
+  case mlx::core::uint8:
+    return mlx_dtype::uint8;
+  case mlx::core::uint16:
+    return mlx_dtype::uint16;
+  case mlx::core::uint32:
+    return mlx_dtype::uint32;
+  case mlx::core::uint64:
+    return mlx_dtype::uint64;
+  case mlx::core::int8:
+    return mlx_dtype::int8;
+  case mlx::core::int16:
+    return mlx_dtype::int16;
+  case mlx::core::int32:
+    return mlx_dtype::int32;
+  case mlx::core::int64:
+    return mlx_dtype::int64;
+  case mlx::core::float16:
+    return mlx_dtype::float16;
+  case mlx::core::float32:
+    return mlx_dtype::float32;
+  case mlx::core::bfloat16:
+    return mlx_dtype::bfloat16;
+  // TODO: case mlx_dtype::complex64:
+  default:
+    throw std::invalid_argument("Invalid dtype enum");
+  }
+}
+
+// Calls `f` with a value-initialized instance of the C++ type matching
+// `dtype`, so kernels can be written once as templates.
+template <typename F>
+void dispatchDtype(Dtype dtype, F &&f) {
+  switch (dtype) {
+  case mlx::core::bool_:
+    return f(bool{});
+  case mlx::core::uint8:
+    return f(uint8_t{});
+  case mlx::core::uint16:
+    return f(uint16_t{});
+  case mlx::core::uint32:
+    return f(uint32_t{});
+  case mlx::core::uint64:
+    return f(uint64_t{});
+  case mlx::core::int8:
+    return f(int8_t{});
+  case mlx::core::int16:
+    return f(int16_t{});
+  case mlx::core::int32:
+    return f(int32_t{});
+  case mlx::core::int64:
+    return f(int64_t{});
+  case mlx::core::float16:
+    return f(float16_t{});
+  case mlx::core::float32:
+    return f(float{});
+  case mlx::core::bfloat16:
+    return f(bfloat16_t{});
+  // TODO: case mlx_dtype::complex64:
+  default:
+    throw std::invalid_argument("Unhandled dtype");
+  }
+}
+
+// Element conversion; half types convert to each other through float.
+template <typename D, typename S>
+inline D convertElement(S v) {
+  if constexpr (std::is_arithmetic_v<S> || std::is_arithmetic_v<D>) {
+    return static_cast<D>(v);
+  } else {
+    return static_cast<D>(static_cast<float>(v));
+  }
+}
+
+// f32 -> bf16 rounding to nearest even on the raw bits (NaNs stay quiet
+// NaNs). Pure integer selects, so the loop below vectorizes where a
+// per-element `bfloat16_t` conversion does not.
+inline uint16_t bfloat16Bits(float f) {
+  uint32_t bits;
+  std::memcpy(&bits, &f, sizeof(bits));
+  uint32_t rounded = bits + 0x7fff + ((bits >> 16) & 1);
+  bool is_nan = (bits & 0x7fffffff) > 0x7f800000;
+  return static_cast<uint16_t>(is_nan ? (bits >> 16) | 0x40 : rounded >> 16);
+}
+
+// Converts `n` contiguous elements of `src` into `dst`.
+template <typename S, typename D>
+void convertContiguous(const S *__restrict src, D *__restrict dst, size_t n) {
+  if constexpr (std::is_same_v<S, float> && std::is_same_v<D, bfloat16_t>) {
+    auto out = reinterpret_cast<uint16_t *>(dst);
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = bfloat16Bits(src[i]);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i) {
+      dst[i] = convertElement<D>(src[i]);
+    }
+  }
+}
+
+// Copies the strided view `src` (strides in elements) into the dense,
+// row-major `dst`, converting each element to `D`. Walks the view one
+// innermost run at a time; unit-stride runs are plain loops the compiler
+// vectorizes, other runs are gathered element by element.
+template <typename S, typename D>
+void gatherConvert(const S *src, D *__restrict dst,
+                   const std::vector<int> &shape,
+                   const std::vector<int64_t> &strides) {
+  size_t total = std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                 std::multiplies<size_t>());
+  if (total == 0) {
+    return;
+  }
+  if (shape.empty()) {
+    dst[0] = convertElement<D>(src[0]);
+    return;
+  }
+  int ndim = shape.size();
+  size_t inner = shape.back();
+  int64_t inner_stride = strides.back();
+  std::vector<int> idx(ndim, 0);
+  int64_t offset = 0;
+  for (size_t outer = total / inner; outer > 0; --outer) {
+    const S *run = src + offset;
+    if (inner_stride == 1) {
+      for (size_t i = 0; i < inner; ++i) {
+        dst[i] = convertElement<D>(run[i]);
+      }
+    } else {
+      for (size_t i = 0; i < inner; ++i) {
+        dst[i] = convertElement<D>(run[i * inner_stride]);
+      }
+    }
+    dst += inner;
+    for (int d = ndim - 2; d >= 0; --d) {
+      if (++idx[d] < shape[d]) {
+        offset += strides[d];
+        break;
+      }
+      offset -= strides[d] * (shape[d] - 1);
+      idx[d] = 0;
+    }
+  }
+}
+
+// Owner of a handle, stored right after its `array` so `destroyArray` can
+// tell heap handles from arena slots and inline storage in O(1), from any
+// thread and whether or not the owning arena is still pushed. The values are
+// arbitrary, so stray pointers are unlikely to read as heap handles.
+enum class HandleKind : uint64_t {
+  heap = 0x6d6c782d68656170,
+  arena = 0x6d6c782d6172656e,
+  storage = 0x6d6c782d73746f72,
+  borrowed = 0x6d6c782d626f7272,
+};
+
+// Memory behind every array handle; the handle points at `bytes`.
+struct HandleSlot {
+  alignas(array) unsigned char bytes[sizeof(array)];
+  HandleKind kind;
+};
+
+template <typename A>
+array *constructHandle(void *mem, A &&a, HandleKind kind) {
+  auto slot = new (mem) HandleSlot;
+  slot->kind = kind;
+  return new (slot->bytes) array(std::forward<A>(a));
+}
+
+HandleKind handleKind(mlx_array arr) {
+  return std::launder(reinterpret_cast<HandleSlot *>(arr))->kind;
+}
+
+// Slab allocator for array handles. Handles placed in an arena are destroyed
+// together by `reset` instead of paying a `new`/`delete` pair each; slabs are
+// kept across resets so steady-state loops stop touching the heap.
+class Arena {
+ public:
+  explicit Arena(size_t slab_size)
+      : slab_size_(std::max<size_t>(slab_size, 1)) {}
+  ~Arena() { reset(); }
+
+  array *place(const array &a) { return commit(reserve(), a); }
+
+  // Returns the slot the next `commit` fills, growing the arena if needed.
+  // Until then the slot stays unused, so a failure in between leaks nothing.
+  void *reserve() {
+    if (cur_slab_ == slabs_.size() || used_ == slab_size_) {
+      if (cur_slab_ < slabs_.size()) {
+        ++cur_slab_;
+        used_ = 0;
+      }
+      if (cur_slab_ == slabs_.size()) {
+        slabs_.push_back(std::make_unique<Slot[]>(slab_size_));
+      }
+    }
+    return &slabs_[cur_slab_][used_];
+  }
+
+  array *commit(void *slot, const array &a) {
+    ++used_;
+    return constructHandle(slot, a, HandleKind::arena);
+  }
+
+  void reset() {
+    for (size_t i = 0; i < slabs_.size() && i <= cur_slab_; ++i) {
+      size_t n = i == cur_slab_ ? used_ : slab_size_;
+      for (size_t j = 0; j < n; ++j) {
+        std::launder(reinterpret_cast<array *>(&slabs_[i][j]))->~array();
+      }
+    }
+    cur_slab_ = 0;
+    used_ = 0;
+  }
+
+ private:
+  struct Slot {
+    alignas(HandleSlot) unsigned char bytes[sizeof(HandleSlot)];
+  };
+
+  size_t slab_size_;
+  size_t cur_slab_ = 0;
+  size_t used_ = 0;
+  std::vector<std::unique_ptr<Slot[]>> slabs_;
+};
+
+// Arenas pushed on the calling thread; the innermost receives new handles.
+thread_local std::vector<Arena *> active_arenas;
+
+// Wraps `a` in a new heap-allocated handle.
+mlx_array heapHandle(const array &a) {
+  return constructHandle(::operator new(sizeof(HandleSlot)), a,
+                         HandleKind::heap);
+}
+
+// Wraps `a` in a new handle, placed in the innermost active arena on this
+// thread if there is one, otherwise on the heap.
+mlx_array newHandle(const array &a) {
+  if (!active_arenas.empty()) {
+    return active_arenas.back()->place(a);
+  }
+  return heapHandle(a);
+}
+
+// Memory for a handle, obtained before the array it will hold is built.
+struct HandleMem {
+  void *mem;
+  Arena *arena;
+};
+
+HandleMem reserveHandle() {
+  if (!active_arenas.empty()) {
+    Arena *arena = active_arenas.back();
+    return {arena->reserve(), arena};
+  }
+  return {::operator new(sizeof(HandleSlot)), nullptr};
+}
+
+// Fills memory from `reserveHandle`; copying an array cannot throw.
+mlx_array placeHandle(HandleMem h, const array &a) {
+  if (h.arena != nullptr) {
+    return h.arena->commit(h.mem, a);
+  }
+  return constructHandle(h.mem, a, HandleKind::heap);
+}
+
+void unreserveHandle(HandleMem h) {
+  if (h.arena == nullptr) {
+    ::operator delete(h.mem);
+  }
+}
+
+// Handle to an input slot of another array, from `editable_inputs`. It holds
+// a copy of the input like any other handle; `assignHandle` forwards writes
+// to `target` so that assigning through it rewires the graph.
+struct BorrowedSlot {
+  HandleSlot slot;
+  array *target;
+};
+
+mlx_array borrowedHandle(array &target) {
+  auto mem = ::operator new(sizeof(BorrowedSlot));
+  auto borrowed = new (mem) BorrowedSlot;
+  borrowed->target = &target;
+  return constructHandle(&borrowed->slot, target, HandleKind::borrowed);
+}
+
+// Stores the result of an `*_into` op in `res`.
+void assignHandle(mlx_array res, const array &value) {
+  if (handleKind(res) == HandleKind::borrowed) {
+    *std::launder(reinterpret_cast<BorrowedSlot *>(res))->target = value;
+  }
+  *static_cast<array *>(res) = value;
+}
+
+void releaseHandle(mlx_array arr) {
+  // arena slots are released in bulk by `mlx_arena_reset`, inline storage by
+  // `array_storage_destroy`
+  if (arr == nullptr) {
+    return;
+  }
+  auto kind = handleKind(arr);
+  if (kind == HandleKind::heap || kind == HandleKind::borrowed) {
+    std::launder(static_cast<array *>(arr))->~array();
+    ::operator delete(arr);
+  }
+}
+
+// Writes a new handle for each of `arrays` to `res`, all or none: if one
+// cannot be created, those created so far are released and `res` is left
+// untouched.
+void newHandles(mlx_array *res, const std::vector<array> &arrays) {
+  std::vector<mlx_array> handles;
+  handles.reserve(arrays.size());
+  try {
+    for (const auto &a : arrays) {
+      handles.push_back(newHandle(a));
+    }
+  } catch (...) {
+    for (auto h : handles) {
+      releaseHandle(h);
+    }
+    throw;
+  }
+  std::copy(handles.begin(), handles.end(), res);
+}
+
+// Tagged `storage` handles holding copies of `arrays`, for handing arrays the
+// shim does not own to callbacks. Destroying or consuming one from the
+// callback leaves its slot to this owner.
+class ScopedHandles {
+ public:
+  explicit ScopedHandles(const std::vector<array> &arrays)
+      : slots_(arrays.size()) {
+    handles_.reserve(arrays.size());
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      handles_.push_back(
+          constructHandle(&slots_[i], arrays[i], HandleKind::storage));
+    }
+  }
+  ~ScopedHandles() {
+    for (auto handle : handles_) {
+      std::launder(static_cast<array *>(handle))->~array();
+    }
+  }
+
+  ScopedHandles(const ScopedHandles &) = delete;
+  ScopedHandles &operator=(const ScopedHandles &) = delete;
+
+  mlx_array *data() { return handles_.data(); }
+  size_t size() const { return handles_.size(); }
+
+ private:
+  std::vector<HandleSlot> slots_;
+  std::vector<mlx_array> handles_;
+};
+
+// Releases an operand handle of a `*_consume` op once its output exists,
+// leaving the graph as the only owner of its buffer. Arena slots and inline
+// storage outlive the call, so their reference is dropped in place instead,
+// leaving an empty array to be released with the slot.
+void consumeHandle(mlx_array arr) {
+  auto kind = handleKind(arr);
+  if (kind == HandleKind::heap || kind == HandleKind::borrowed) {
+    releaseHandle(arr);
+  } else {
+    array dropped(std::move(*static_cast<array *>(arr)));
+  }
+}
+
+void releaseInputs(mlx_array lhs, bool consume_lhs, mlx_array rhs,
+                   bool consume_rhs) {
+  if (consume_lhs) {
+    consumeHandle(lhs);
+  }
+  if (consume_rhs && !(consume_lhs && lhs == rhs)) {
+    consumeHandle(rhs);
+  }
+}
+
+// Streams pushed on the calling thread; ops issued by the bindings run on the
+// innermost one, falling back to MLX's default stream.
+thread_local std::vector<Stream> active_streams;
+
+StreamOrDevice currentStream() {
+  if (active_streams.empty()) {
+    return {};
+  }
+  return active_streams.back();
+}
+
+// Key argument of the keyed random bindings; a NULL handle selects MLX's
+// global random state.
+std::optional<array> optionalKey(mlx_array key) {
+  if (key == nullptr) {
+    return std::nullopt;
+  }
+  return *static_cast<array *>(key);
+}
+
+// Shape of a batch of `n` samples of `shape_len` dims, sample index first.
+std::vector<int> batchShape(size_t n, const void *shape, size_t shape_len) {
+  auto shape_int = reinterpret_cast<const int *>(shape);
+  std::vector<int> res{static_cast<int>(n)};
+  res.insert(res.end(), shape_int, shape_int + shape_len);
+  return res;
+}
+
+// Writes the `n` rows of `batch` (one per sample) to `res`.
+void writeBatch(mlx_array *res, size_t n, const array &batch) {
+  auto rows = mlx::core::split(batch, static_cast<int>(n), 0, currentStream());
+  for (auto &row : rows) {
+    row = mlx::core::squeeze(row, 0, currentStream());
+  }
+  newHandles(res, rows);
+}
+
+// Dtype a scalar operand takes when combined with `arr`: the array's own
+// dtype, except that float scalars promote integer/bool arrays to float32.
+Dtype scalarDtype(const array &arr, const mlx_scalar &val) {
+  if (val.kind == mlx_scalar_float && !is_floating_point(arr.dtype()) &&
+      arr.dtype() != mlx::core::complex64) {
+    return mlx::core::float32;
+  }
+  return arr.dtype();
+}
+
+// Scalars common enough in elementwise code to be worth sharing per dtype.
+constexpr double kCachedScalars[] = {0.0, 1.0, -1.0, 0.5};
+constexpr size_t kNumCachedScalars =
+    sizeof(kCachedScalars) / sizeof(kCachedScalars[0]);
+constexpr size_t kNumCachedDtypes = mlx_dtype::bfloat16 + 1;
+
+// Returns a scalar array of `dtype`, reusing a cached constant when `val` is
+// one of `kCachedScalars`. The cache is intentionally leaked so it outlives
+// MLX's allocator during static destruction.
+array scalarArray(double val, Dtype dtype) {
+  if (dtype == mlx::core::complex64) {
+    return array(val, dtype);
+  }
+  static std::once_flag once[kNumCachedDtypes];
+  static std::vector<array> *cache[kNumCachedDtypes];
+  for (size_t i = 0; i < kNumCachedScalars; ++i) {
+    if (val != kCachedScalars[i] ||
+        std::signbit(val) != std::signbit(kCachedScalars[i])) {
+      continue;
+    }
+    size_t idx = enumFromDtype(dtype);
+    std::call_once(once[idx], [idx, dtype]() {
+      cache[idx] = new std::vector<array>();
+      for (double c : kCachedScalars) {
+        cache[idx]->push_back(array(c, dtype));
+      }
+    });
+    return (*cache[idx])[i];
+  }
+  return array(val, dtype);
+}
+
+// Integer scalars reuse the `double` overload (and its cache) when that is
+// lossless or the target dtype is floating anyway; integers beyond 2^53 are
+// built straight from their 64-bit value.
+array scalarArray(const mlx_scalar &val, Dtype dtype) {
+  constexpr uint64_t kMaxExact = uint64_t{1} << 53;
+  bool to_float = is_floating_point(dtype) || dtype == mlx::core::complex64;
+  switch (val.kind) {
+  case mlx_scalar_int:
+    if (to_float || (val.val.i <= int64_t(kMaxExact) &&
+                      val.val.i >= -int64_t(kMaxExact))) {
+      return scalarArray(static_cast<double>(val.val.i), dtype);
+    }
+    return array(val.val.i, dtype);
+  case mlx_scalar_uint:
+    if (to_float || val.val.u <= kMaxExact) {
+      return scalarArray(static_cast<double>(val.val.u), dtype);
+    }
+    return array(val.val.u, dtype);
+  default:
+    return scalarArray(val.val.f, dtype);
+  }
+}
+
+// Private, copy-on-write mapping of a whole file, shared by every array that
+// points into it and unmapped once the last of them is released. Pages are
+// only read from disk when an array is first touched (i.e. on eval).
+struct FileMapping {
+  char *addr = nullptr;
+  size_t len = 0;
+
+  explicit FileMapping(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Failed to open " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error("Failed to stat " + path);
+    }
+    len = st.st_size;
+    // writable private pages keep MLX free to donate the buffer in place
+    void *ptr = len == 0 ? MAP_FAILED
+                         : ::mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (ptr == MAP_FAILED) {
+      throw std::runtime_error("Failed to map " + path);
+    }
+    addr = static_cast<char *>(ptr);
+  }
+  ~FileMapping() { ::munmap(addr, len); }
+  FileMapping(const FileMapping &) = delete;
+  FileMapping &operator=(const FileMapping &) = delete;
+};
+
+// Wraps `len` bytes at `offset` of `mapping` as an array without copying.
+// Falls back to a copy when the data is not aligned for `dtype`.
+array mappedArray(const std::shared_ptr<FileMapping> &mapping, size_t offset,
+                  size_t len, std::vector<int> shape, Dtype dtype) {
+  size_t count = std::accumulate(shape.begin(), shape.end(), size_t(1),
+                                 std::multiplies<size_t>());
+  if (offset > mapping->len || len > mapping->len - offset ||
+      len != count * size_of(dtype)) {
+    throw std::invalid_argument("Tensor data is out of bounds of the file");
+  }
+  char *ptr = mapping->addr + offset;
+  if (reinterpret_cast<uintptr_t>(ptr) % size_of(dtype) == 0) {
+    return array(ptr, shape, dtype, [mapping](void *) {});
+  }
+  std::optional<array> res;
+  dispatchDtype(dtype, [&](auto tag) {
+    using T = decltype(tag);
+    auto aligned = std::make_unique<T[]>(count);
+    std::memcpy(aligned.get(), ptr, len);
+    res = array(static_cast<const T *>(aligned.get()), shape, dtype);
+  });
+  return *res;
+}
+
+// Minimal reader for safetensors JSON headers, which only contain objects,
+// arrays, strings and non-negative integers.
+class HeaderParser {
+ public:
+  HeaderParser(const char *begin, const char *end) : p_(begin), end_(end) {}
+
+  void expect(char c) {
+    skipSpace();
+    if (p_ == end_ || *p_ != c) {
+      throw std::invalid_argument(std::string("Malformed header, expected '") +
+                                  c + "'");
+    }
+    ++p_;
+  }
+
+  // Consumes `c` if it is the next non-space character.
+  bool consume(char c) {
+    skipSpace();
+    if (p_ != end_ && *p_ == c) {
+      ++p_;
+      return true;
+    }
+    return false;
+  }
+
+  std::string parseString() {
+    expect('"');
+    std::string res;
+    while (p_ != end_ && *p_ != '"') {
+      if (*p_ == '\\' && p_ + 1 != end_) {
+        ++p_;
+      }
+      res.push_back(*p_++);
+    }
+    expect('"');
+    return res;
+  }
+
+  uint64_t parseUint() {
+    skipSpace();
+    if (p_ == end_ || !std::isdigit(static_cast<unsigned char>(*p_))) {
+      throw std::invalid_argument("Malformed header, expected an integer");
+    }
+    uint64_t res = 0;
+    while (p_ != end_ && std::isdigit(static_cast<unsigned char>(*p_))) {
+      res = res * 10 + (*p_++ - '0');
+    }
+    return res;
+  }
+
+  std::vector<uint64_t> parseUintArray() {
+    std::vector<uint64_t> res;
+    expect('[');
+    if (consume(']')) {
+      return res;
+    }
+    do {
+      res.push_back(parseUint());
+    } while (consume(','));
+    expect(']');
+    return res;
+  }
+
+  void skipValue() {
+    skipSpace();
+    if (p_ == end_) {
+      throw std::invalid_argument("Malformed header, unexpected end");
+    }
+    if (*p_ == '"') {
+      parseString();
+    } else if (*p_ == '{' || *p_ == '[') {
+      char close = *p_ == '{' ? '}' : ']';
+      ++p_;
+      if (consume(close)) {
+        return;
+      }
+      do {
+        if (close == '}') {
+          parseString();
+          expect(':');
+        }
+        skipValue();
+      } while (consume(','));
+      expect(close);
+    } else {
+      while (p_ != end_ && *p_ != ',' && *p_ != '}' && *p_ != ']') {
+        ++p_;
+      }
+    }
+  }
+
+ private:
+  void skipSpace() {
+    while (p_ != end_ && std::isspace(static_cast<unsigned char>(*p_))) {
+      ++p_;
+    }
+  }
+
+  const char *p_;
+  const char *end_;
+};
+
+Dtype dtypeFromSafetensors(const std::string &name) {
+  static const std::unordered_map<std::string, Dtype> dtypes = {
+      {"BOOL", mlx::core::bool_},  {"U8", mlx::core::uint8},
+      {"U16", mlx::core::uint16},  {"U32", mlx::core::uint32},
+      {"U64", mlx::core::uint64},  {"I8", mlx::core::int8},
+      {"I16", mlx::core::int16},   {"I32", mlx::core::int32},
+      {"I64", mlx::core::int64},   {"F16", mlx::core::float16},
+      {"F32", mlx::core::float32}, {"BF16", mlx::core::bfloat16},
+  };
+  auto it = dtypes.find(name);
+  if (it == dtypes.end()) {
+    throw std::invalid_argument("Unsupported safetensors dtype: " + name);
+  }
+  return it->second;
+}
+
+const char *safetensorsFromDtype(Dtype dtype) {
+  switch (dtype) {
+  case mlx::core::bool_:
+    return "BOOL";
+  case mlx::core::uint8:
+    return "U8";
+  case mlx::core::uint16:
+    return "U16";
+  case mlx::core::uint32:
+    return "U32";
+  case mlx::core::uint64:
+    return "U64";
+  case mlx::core::int8:
+    return "I8";
+  case mlx::core::int16:
+    return "I16";
+  case mlx::core::int32:
+    return "I32";
+  case mlx::core::int64:
+    return "I64";
+  case mlx::core::float16:
+    return "F16";
+  case mlx::core::float32:
+    return "F32";
+  case mlx::core::bfloat16:
+    return "BF16";
+  // TODO: case mlx_dtype::complex64:
+  default:
+    throw std::invalid_argument("Unhandled dtype");
+  }
+}
+
+// Name -> array map returned by `load_safetensors`, sorted by name.
+using ArrayMap = std::vector<std::pair<std::string, array>>;
+
+ArrayMap loadSafetensorsMapped(const std::string &path) {
+  auto mapping = std::make_shared<FileMapping>(path);
+  if (mapping->len < 8) {
+    throw std::invalid_argument("File too small for safetensors: " + path);
+  }
+  uint64_t header_len = 0;
+  for (int i = 7; i >= 0; --i) {
+    header_len = (header_len << 8) | static_cast<uint8_t>(mapping->addr[i]);
+  }
+  if (header_len > mapping->len - 8) {
+    throw std::invalid_argument("Malformed safetensors header: " + path);
+  }
+  size_t data_start = 8 + header_len;
+  HeaderParser parser(mapping->addr + 8, mapping->addr + data_start);
+  ArrayMap res;
+  parser.expect('{');
+  if (parser.consume('}')) {
+    return res;
+  }
+  do {
+    auto name = parser.parseString();
+    parser.expect(':');
+    if (name == "__metadata__") {
+      parser.skipValue();
+      continue;
+    }
+    std::string dtype_name;
+    std::vector<uint64_t> shape, offsets;
+    parser.expect('{');
+    do {
+      auto key = parser.parseString();
+      parser.expect(':');
+      if (key == "dtype") {
+        dtype_name = parser.parseString();
+      } else if (key == "shape") {
+        shape = parser.parseUintArray();
+      } else if (key == "data_offsets") {
+        offsets = parser.parseUintArray();
+      } else {
+        parser.skipValue();
+      }
+    } while (parser.consume(','));
+    parser.expect('}');
+    if (offsets.size() != 2 || offsets[1] < offsets[0]) {
+      throw std::invalid_argument("Malformed data_offsets for " + name);
+    }
+    std::vector<int> shape_vec(shape.begin(), shape.end());
+    res.emplace_back(name, mappedArray(mapping, data_start + offsets[0],
+                                       offsets[1] - offsets[0], shape_vec,
+                                       dtypeFromSafetensors(dtype_name)));
+  } while (parser.consume(','));
+  parser.expect('}');
+  std::sort(res.begin(), res.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  return res;
+}
+
+// Maps little-endian/native npy descriptors to MLX dtypes.
+std::optional<Dtype> dtypeFromNpy(const std::string &descr) {
+  static const std::unordered_map<std::string, Dtype> dtypes = {
+      {"b1", mlx::core::bool_},  {"u1", mlx::core::uint8},
+      {"u2", mlx::core::uint16}, {"u4", mlx::core::uint32},
+      {"u8", mlx::core::uint64}, {"i1", mlx::core::int8},
+      {"i2", mlx::core::int16},  {"i4", mlx::core::int32},
+      {"i8", mlx::core::int64},  {"f2", mlx::core::float16},
+      {"f4", mlx::core::float32},
+  };
+  if (descr.size() != 3 || descr[0] == '>') {
+    return std::nullopt;
+  }
+  auto it = dtypes.find(descr.substr(1));
+  if (it == dtypes.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+// Maps a C-ordered, little-endian .npy file; anything else goes through
+// MLX's own (copying) loader.
+array loadNpyMapped(const std::string &path) {
+  auto mapping = std::make_shared<FileMapping>(path);
+  const char *p = mapping->addr;
+  if (mapping->len < 10 || std::memcmp(p, "\x93NUMPY", 6) != 0) {
+    throw std::invalid_argument("Not an npy file: " + path);
+  }
+  size_t header_len, header_start;
+  if (p[6] == 1) {
+    header_len = static_cast<uint8_t>(p[8]) |
+                 (static_cast<size_t>(static_cast<uint8_t>(p[9])) << 8);
+    header_start = 10;
+  } else {
+    if (mapping->len < 12) {
+      throw std::invalid_argument("Malformed npy header: " + path);
+    }
+    header_len = 0;
+    for (int i = 11; i >= 8; --i) {
+      header_len = (header_len << 8) | static_cast<uint8_t>(p[i]);
+    }
+    header_start = 12;
+  }
+  if (header_len > mapping->len - header_start) {
+    throw std::invalid_argument("Malformed npy header: " + path);
+  }
+  std::string header(p + header_start, header_len);
+  auto field = [&header, &path](const std::string &key) {
+    auto pos = header.find("'" + key + "':");
+    if (pos == std::string::npos) {
+      throw std::invalid_argument("Missing '" + key + "' in " + path);
+    }
+    pos += key.size() + 3;
+    return header.substr(header.find_first_not_of(' ', pos));
+  };
+  auto descr = field("descr");
+  descr = descr.substr(1, descr.find('\'', 1) - 1);
+  auto dtype = dtypeFromNpy(descr);
+  bool fortran_order = field("fortran_order").rfind("True", 0) == 0;
+  if (!dtype || fortran_order) {
+    return mlx::core::load(path, currentStream());
+  }
+  auto shape_str = field("shape");
+  shape_str = shape_str.substr(1, shape_str.find(')') - 1);
+  std::vector<int> shape_vec;
+  for (size_t pos = 0; pos < shape_str.size();) {
+    auto next = shape_str.find(',', pos);
+    auto dim = shape_str.substr(pos, next - pos);
+    if (dim.find_first_not_of(' ') != std::string::npos) {
+      shape_vec.push_back(std::stoi(dim));
+    }
+    if (next == std::string::npos) {
+      break;
+    }
+    pos = next + 1;
+  }
+  size_t data_start = header_start + header_len;
+  size_t count = std::accumulate(shape_vec.begin(), shape_vec.end(),
+                                 size_t(1), std::multiplies<size_t>());
+  return mappedArray(mapping, data_start, count * size_of(*dtype), shape_vec,
+                     *dtype);
+}
+
+void writeJsonString(std::string &out, const std::string &s) {
+  out.push_back('"');
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+      out.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      out += buf;
+    } else {
+      out.push_back(c);
+    }
+  }
+  out.push_back('"');
+}
+
+// Writes `arrs` to a safetensors file one array at a time: the header only
+// needs shapes and dtypes, so each array is evaluated and written on its own
+// and no combined in-memory copy is ever built.
+void saveSafetensorsStreaming(const std::string &path,
+                              const std::vector<std::string> &names,
+                              const std::vector<array> &arrs) {
+  std::string header = "{";
+  size_t offset = 0;
+  for (size_t i = 0; i < arrs.size(); ++i) {
+    if (i > 0) {
+      header.push_back(',');
+    }
+    writeJsonString(header, names[i]);
+    header += ":{\"dtype\":\"";
+    header += safetensorsFromDtype(arrs[i].dtype());
+    header += "\",\"shape\":[";
+    for (size_t d = 0; d < arrs[i].ndim(); ++d) {
+      header += (d > 0 ? "," : "") + std::to_string(arrs[i].shape(d));
+    }
+    header += "],\"data_offsets\":[" + std::to_string(offset) + ",";
+    offset += arrs[i].nbytes();
+    header += std::to_string(offset) + "]}";
+  }
+  header.push_back('}');
+  // pad so the data section starts 8-byte aligned
+  header.append((8 - header.size() % 8) % 8, ' ');
+
+  std::unique_ptr<FILE, int (*)(FILE *)> file(std::fopen(path.c_str(), "wb"),
+                                             &std::fclose);
+  if (!file) {
+    throw std::runtime_error("Failed to open " + path);
+  }
+  auto write = [&file, &path](const void *data, size_t n) {
+    if (n > 0 && std::fwrite(data, 1, n, file.get()) != n) {
+      throw std::runtime_error("Failed to write " + path);
+    }
+  };
+  uint8_t len_bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    len_bytes[i] = static_cast<uint8_t>(uint64_t(header.size()) >> (8 * i));
+  }
+  write(len_bytes, sizeof(len_bytes));
+  write(header.data(), header.size());
+  for (auto a : arrs) {
+    evalShared({a});
+    if (a.flags().row_contiguous) {
+      write(a.data<char>(), a.nbytes());
+      continue;
+    }
+    std::vector<char> dense(a.nbytes());
+    std::vector<int> shape_vec(a.shape().begin(), a.shape().end());
+    std::vector<int64_t> strides_vec(a.strides().begin(), a.strides().end());
+    dispatchDtype(a.dtype(), [&](auto tag) {
+      using T = decltype(tag);
+      gatherConvert(a.data<T>(), reinterpret_cast<T *>(dense.data()),
+                    shape_vec, strides_vec);
+    });
+    write(dense.data(), dense.size());
+  }
+}
+
+// Copies the handles in `arrs` into a vector of (shared) MLX arrays.
+std::vector<array> collectArrays(const mlx_array *arrs, size_t n) {
+  std::vector<array> res;
+  res.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    res.push_back(*static_cast<array *>(arrs[i]));
+  }
+  return res;
+}
+
+array binaryOp(mlx_binary_op op, const array &lhs, const array &rhs) {
+  switch (op) {
+  case mlx_binary_op::mlx_op_add:
+    return mlx::core::add(lhs, rhs, currentStream());
+  case mlx_binary_op::mlx_op_subtract:
+    return mlx::core::subtract(lhs, rhs, currentStream());
+  case mlx_binary_op::mlx_op_multiply:
+    return mlx::core::multiply(lhs, rhs, currentStream());
+  case mlx_binary_op::mlx_op_divide:
+    return mlx::core::divide(lhs, rhs, currentStream());
+  default:
+    throw std::invalid_argument("Invalid binary op enum");
+  }
+}
+
+// Resolves the array operands of batched ops; scalars resolve to nullopt.
+std::optional<array> batchOperand(const mlx_operand &operand,
+                                  const std::vector<array> &results) {
+  if (operand.result >= 0) {
+    if (static_cast<size_t>(operand.result) >= results.size()) {
+      throw std::out_of_range("Operand refers to a later op in the batch");
+    }
+    return results[operand.result];
+  }
+  if (operand.arr != nullptr) {
+    return *static_cast<array *>(operand.arr);
+  }
+  return std::nullopt;
+}
+
+// Outputs of an `async_eval` call; waiting re-enters `eval`, which blocks
+// until the already scheduled work completes.
+struct Future {
+  std::vector<array> outputs;
+};
+
+// A function compiled with `compile_fn`. `id` keys MLX's compile cache, which
+// holds one traced/fused graph per input shape and dtype signature.
+struct Compiled {
+  std::function<std::vector<array>(const std::vector<array> &)> fn;
+  std::uintptr_t id;
+  size_t n_outputs;
+};
+
+const char *dtypeName(Dtype dtype) {
+  static const char *names[] = {
+      "bool",  "uint8",   "uint16",  "uint32",   "uint64",   "int8",  "int16",
+      "int32", "int64",   "float16", "float32",  "bfloat16", "complex64"};
+  return names[enumFromDtype(dtype)];
+}
+
+// Name of the primitive producing `a`, or nullptr for leaves (including
+// arrays detached by an earlier eval).
+const char *primitiveName(const array &a) {
+  return a.has_primitive() ? a.primitive().name() : nullptr;
+}
+
+// Arrays reachable from a set of outputs, each listed after its inputs.
+// `inputs[i]` holds the node indices of the inputs of `nodes[i]`, and
+// `live_bytes[i]` the estimated resident bytes once `nodes[i]` is computed.
+struct Graph {
+  std::vector<array> nodes;
+  // shapes widened to the int64 dims of the public API
+  std::vector<std::vector<int64_t>> shapes;
+  std::vector<std::vector<size_t>> inputs;
+  std::vector<size_t> live_bytes;
+  size_t resident_bytes = 0;
+  size_t pending_bytes = 0;
+  size_t peak_bytes = 0;
+};
+
+// Simulates evaluating `g` in node order: evaluated arrays stay resident, each
+// pending node allocates its output, and intermediates are freed after their
+// last use. Buffer donation would only lower the estimate.
+void estimateMemory(Graph &g, const std::vector<bool> &is_output) {
+  std::vector<size_t> uses(g.nodes.size(), 0);
+  for (const auto &ins : g.inputs) {
+    for (auto j : ins) {
+      ++uses[j];
+    }
+  }
+  for (const auto &a : g.nodes) {
+    (a.is_evaled() ? g.resident_bytes : g.pending_bytes) += a.nbytes();
+  }
+  size_t live = g.resident_bytes;
+  g.peak_bytes = live;
+  g.live_bytes.assign(g.nodes.size(), 0);
+  for (size_t i = 0; i < g.nodes.size(); ++i) {
+    if (!g.nodes[i].is_evaled()) {
+      live += g.nodes[i].nbytes();
+      g.peak_bytes = std::max(g.peak_bytes, live);
+      for (auto j : g.inputs[i]) {
+        if (--uses[j] == 0 && !is_output[j] && !g.nodes[j].is_evaled()) {
+          live -= g.nodes[j].nbytes();
+        }
+      }
+    }
+    g.live_bytes[i] = live;
+  }
+}
+
+Graph buildGraph(const std::vector<array> &outputs) {
+  Graph g;
+  std::unordered_map<std::uintptr_t, size_t> index;
+  // iterative DFS; an entry is expanded once its inputs have been pushed
+  std::vector<std::pair<array, bool>> stack;
+  for (auto it = outputs.rbegin(); it != outputs.rend(); ++it) {
+    stack.emplace_back(*it, false);
+  }
+  while (!stack.empty()) {
+    auto [a, expanded] = stack.back();
+    stack.pop_back();
+    if (index.count(a.id()) > 0) {
+      continue;
+    }
+    if (!expanded) {
+      stack.emplace_back(a, true);
+      for (const auto &in : a.inputs()) {
+        if (index.count(in.id()) == 0) {
+          stack.emplace_back(in, false);
+        }
+      }
+      continue;
+    }
+    std::vector<size_t> ins;
+    for (const auto &in : a.inputs()) {
+      ins.push_back(index.at(in.id()));
+    }
+    index.emplace(a.id(), g.nodes.size());
+    g.nodes.push_back(a);
+    g.shapes.emplace_back(a.shape().begin(), a.shape().end());
+    g.inputs.push_back(std::move(ins));
+  }
+  std::vector<bool> is_output(g.nodes.size(), false);
+  for (const auto &out : outputs) {
+    is_output[index.at(out.id())] = true;
+  }
+  estimateMemory(g, is_output);
+  return g;
+}
+
+std::string shapeString(const array &a) {
+  std::string res = "[";
+  for (size_t d = 0; d < a.ndim(); ++d) {
+    res += (d > 0 ? ", " : "") + std::to_string(a.shape(d));
+  }
+  return res + "]";
+}
+
+// Evaluated nodes are filled; each label holds the primitive, shape, dtype,
+// output size and estimated resident bytes after the node runs.
+std::string graphToDot(const Graph &g) {
+  std::string out = "digraph mlx {\n  node [shape=box];\n";
+  for (size_t i = 0; i < g.nodes.size(); ++i) {
+    const auto &a = g.nodes[i];
+    auto name = primitiveName(a);
+    out += "  n" + std::to_string(i) + " [label=\"" +
+           (name != nullptr ? name : "leaf") + "\\n" + shapeString(a) + " " +
+           dtypeName(a.dtype()) + "\\n" + std::to_string(a.nbytes()) +
+           " B, live " + std::to_string(g.live_bytes[i]) + " B\"";
+    out += a.is_evaled() ? ", style=filled];\n" : "];\n";
+    for (auto j : g.inputs[i]) {
+      out += "  n" + std::to_string(j) + " -> n" + std::to_string(i) + ";\n";
+    }
+  }
+  return out + "}\n";
+}
+
+std::string graphToJson(const Graph &g) {
+  std::string out = "{\"resident_bytes\":" + std::to_string(g.resident_bytes) +
+                    ",\"pending_bytes\":" + std::to_string(g.pending_bytes) +
+                    ",\"peak_bytes\":" + std::to_string(g.peak_bytes) +
+                    ",\"nodes\":[";
+  for (size_t i = 0; i < g.nodes.size(); ++i) {
+    const auto &a = g.nodes[i];
+    auto name = primitiveName(a);
+    out += i > 0 ? ",{\"id\":" : "{\"id\":";
+    out += std::to_string(a.id()) + ",\"primitive\":";
+    if (name != nullptr) {
+      writeJsonString(out, name);
+    } else {
+      out += "null";
+    }
+    out += ",\"shape\":[";
+    for (size_t d = 0; d < a.ndim(); ++d) {
+      out += (d > 0 ? "," : "") + std::to_string(a.shape(d));
+    }
+    out += "],\"dtype\":\"" + std::string(dtypeName(a.dtype())) +
+           "\",\"nbytes\":" + std::to_string(a.nbytes()) +
+           ",\"is_evaled\":" + (a.is_evaled() ? "true" : "false") +
+           ",\"live_bytes\":" + std::to_string(g.live_bytes[i]) +
+           ",\"inputs\":[";
+    for (size_t k = 0; k < g.inputs[i].size(); ++k) {
+      out += (k > 0 ? "," : "") + std::to_string(g.inputs[i][k]);
+    }
+    out += "]}";
+  }
+  return out + "]}\n";
+}
+
+extern "C" {
+
+void destroyArray(mlx_array arr) { releaseHandle(arr); }
+
+void destroyArrayIterator(mlx_array_iterator iter) {
+  delete static_cast<array::ArrayIterator*>(iter);
+}
+
+void destroyFuture(mlx_future fut) { delete static_cast<Future *>(fut); }
+
+
+void mlx_last_error(mlx_error_info *res) {
+  res->code = last_error.code;
+  res->op = last_error.op;
+  res->message = last_error.message;
+}
+
+void mlx_clear_error() { last_error = ErrorRecord(); }
+
+void mlx_arena_destroy(mlx_arena arena) {
+  // never leave a dangling arena on this thread's stack, even if it was not
+  // popped (or popped out of order)
+  active_arenas.erase(
+      std::remove(active_arenas.begin(), active_arenas.end(), arena),
+      active_arenas.end());
+  delete static_cast<Arena *>(arena);
+}
+
+mlx_err mlx_arena_create(mlx_arena *res, size_t slab_size) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_arena new_arena = new Arena(slab_size);
+    std::swap(*res, new_arena);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+void mlx_profile_enable(bool enabled) {
+  profiling_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool mlx_profile_enabled(void) {
+  return profiling_enabled.load(std::memory_order_relaxed);
+}
+
+void mlx_profile_reset(void) { profiler().reset(); }
+
+mlx_err mlx_profile_size(size_t *res) {
+  try {
+    *res = profiler().size();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err mlx_profile_stat_at(mlx_profile_stat *res, size_t idx) {
+  try {
+    *res = profiler().stat(idx);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err mlx_profile_save_trace(const char *path) {
+  try {
+    auto out = profiler().traceJson();
+    std::unique_ptr<FILE, int (*)(FILE *)> file(std::fopen(path, "wb"),
+                                               &std::fclose);
+    if (!file) {
+      throw std::runtime_error(std::string("Failed to open ") + path);
+    }
+    if (std::fwrite(out.data(), 1, out.size(), file.get()) != out.size()) {
+      throw std::runtime_error(std::string("Failed to write ") + path);
+    }
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err mlx_arena_reset(mlx_arena arena) {
+  ProfileScope profile(__func__);
+  try {
+    static_cast<Arena *>(arena)->reset();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err mlx_arena_push(mlx_arena arena) {
+  ProfileScope profile(__func__);
+  try {
+    active_arenas.push_back(static_cast<Arena *>(arena));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err mlx_arena_pop(mlx_arena arena) {
+  ProfileScope profile(__func__);
+  try {
+    if (active_arenas.empty() || active_arenas.back() != arena) {
+      throw std::invalid_argument("Arena is not the innermost active arena");
+    }
+    active_arenas.pop_back();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err cloneHandle(mlx_array *res, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    // always heap-allocated so the handle can outlive any active arena
+    mlx_array new_array = heapHandle(*static_cast<array *>(arr));
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+// `mlx_array_storage` must be able to hold a tagged handle in place.
+static_assert(sizeof(HandleSlot) <= sizeof(mlx_array_storage),
+              "mlx_array_storage is too small for an array handle");
+static_assert(alignof(HandleSlot) <= alignof(mlx_array_storage),
+              "mlx_array_storage is under-aligned for an array handle");
+
+mlx_err array_storage_copy(mlx_array_storage *dst, mlx_array src) {
+  ProfileScope profile(__func__);
+  try {
+    constructHandle(dst, *static_cast<array *>(src), HandleKind::storage);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err array_storage_move(mlx_array_storage *dst, mlx_array src) {
+  ProfileScope profile(__func__);
+  try {
+    constructHandle(dst, std::move(*static_cast<array *>(src)),
+                    HandleKind::storage);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err array_storage_take(mlx_array_storage *dst, mlx_array src) {
+  ProfileScope profile(__func__);
+  try {
+    constructHandle(dst, std::move(*static_cast<array *>(src)),
+                    HandleKind::storage);
+    releaseHandle(src);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+void array_storage_destroy(mlx_array_storage *storage) {
+  std::launder(reinterpret_cast<array *>(storage))->~array();
+}
+
+void destroyStream(mlx_stream stream) { delete static_cast<Stream *>(stream); }
+
+mlx_err new_cpu_stream(mlx_stream *res) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_stream new_stream = new Stream(mlx::core::new_stream(Device::cpu));
+    std::swap(*res, new_stream);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err default_cpu_stream(mlx_stream *res) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_stream new_stream = new Stream(mlx::core::default_stream(Device::cpu));
+    std::swap(*res, new_stream);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err set_default_stream(mlx_stream stream) {
+  ProfileScope profile(__func__);
+  try {
+    mlx::core::set_default_stream(*static_cast<Stream *>(stream));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err synchronize(mlx_stream stream) {
+  ProfileScope profile(__func__);
+  try {
+    mlx::core::synchronize(*static_cast<Stream *>(stream));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err stream_push(mlx_stream stream) {
+  ProfileScope profile(__func__);
+  try {
+    active_streams.push_back(*static_cast<Stream *>(stream));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err stream_pop(mlx_stream stream) {
+  ProfileScope profile(__func__);
+  try {
+    if (active_streams.empty() ||
+        !(active_streams.back() == *static_cast<Stream *>(stream))) {
+      throw std::invalid_argument("Stream is not the innermost active stream");
+    }
+    active_streams.pop_back();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err seed(uint64_t seed) {
+  ProfileScope profile(__func__);
+  try {
+    std::lock_guard<std::mutex> lock(random_mutex);
+    random::seed(seed);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err get_active_memory(size_t *res) {
+  ProfileScope profile(__func__);
+  try {
+    *res = mlx::core::get_active_memory();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err get_peak_memory(size_t *res) {
+  ProfileScope profile(__func__);
+  try {
+    *res = mlx::core::get_peak_memory();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err get_cache_memory(size_t *res) {
+  ProfileScope profile(__func__);
+  try {
+    *res = mlx::core::get_cache_memory();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err reset_peak_memory() {
+  ProfileScope profile(__func__);
+  try {
+    mlx::core::reset_peak_memory();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err set_memory_limit(size_t *res, size_t limit) {
+  ProfileScope profile(__func__);
+  try {
+    *res = mlx::core::set_memory_limit(limit);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err set_cache_limit(size_t *res, size_t limit) {
+  ProfileScope profile(__func__);
+  try {
+    *res = mlx::core::set_cache_limit(limit);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err clear_cache() {
+  ProfileScope profile(__func__);
+  try {
+    mlx::core::clear_cache();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+void destroyCompiled(mlx_compiled compiled) {
+  auto c = static_cast<Compiled *>(compiled);
+  {
+    std::lock_guard<std::recursive_mutex> lock(compile_mutex);
+    mlx::core::detail::compile_erase(c->id);
+  }
+  delete c;
+}
+
+mlx_err compile_fn(mlx_compiled *res, mlx_closure_fn fn, void *ctx,
+                   size_t n_outputs, bool shapeless) {
+  ProfileScope profile(__func__);
+  try {
+    // Runs `fn` on the tracer inputs. Output handles created by `fn` are
+    // consumed here, the input handles are released once `fn` returns.
+    auto closure = [fn, ctx, n_outputs](const std::vector<array> &inputs) {
+      ScopedHandles in_handles(inputs);
+      std::vector<mlx_array> out_handles(n_outputs, nullptr);
+      // a failure inside `fn` is recorded by the binding that raised it
+      ErrorRecord outer = last_error;
+      last_error = ErrorRecord();
+      auto err = fn(out_handles.data(), n_outputs, in_handles.data(),
+                    in_handles.size(), ctx);
+      std::vector<array> outputs;
+      for (auto handle : out_handles) {
+        if (handle != nullptr) {
+          outputs.push_back(*static_cast<array *>(handle));
+          releaseHandle(handle);
+        }
+      }
+      if (err != mlx_err::mlx_success) {
+        if (last_error.code == mlx_err::mlx_success) {
+          recordError(err, "compiled_call", "Compiled function failed");
+        }
+        throw RecordedError();
+      }
+      last_error = outer;
+      if (outputs.size() != n_outputs) {
+        throw std::invalid_argument("Compiled function left outputs unset");
+      }
+      return outputs;
+    };
+    auto compiled = std::make_unique<Compiled>();
+    compiled->id = reinterpret_cast<std::uintptr_t>(compiled.get());
+    compiled->n_outputs = n_outputs;
+    std::lock_guard<std::recursive_mutex> lock(compile_mutex);
+    compiled->fn = mlx::core::detail::compile(closure, compiled->id, shapeless);
+    mlx_compiled new_compiled = compiled.release();
+    std::swap(*res, new_compiled);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err compiled_call(mlx_array *outputs, size_t n_outputs,
+                      mlx_compiled compiled, const mlx_array *inputs,
+                      size_t n_inputs) {
+  ProfileScope profile(__func__);
+  try {
+    auto c = static_cast<Compiled *>(compiled);
+    if (n_outputs != c->n_outputs) {
+      throw std::invalid_argument("Output count does not match compiled fn");
+    }
+    std::vector<array> res;
+    {
+      std::lock_guard<std::recursive_mutex> lock(compile_mutex);
+      res = c->fn(collectArrays(inputs, n_inputs));
+    }
+    newHandles(outputs, res);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+void destroyArrayMap(mlx_array_map map) {
+  delete static_cast<ArrayMap *>(map);
+}
+
+mlx_err load_safetensors(mlx_array_map *res, const char *path) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_array_map new_map = new ArrayMap(loadSafetensorsMapped(path));
+    std::swap(*res, new_map);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err load_npy(mlx_array *res, const char *path) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_array new_array = newHandle(loadNpyMapped(path));
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err array_map_size(size_t *res, mlx_array_map map) {
+  ProfileScope profile(__func__);
   try {
-    if (eptr)
-      std::rethrow_exception(eptr);
-  } catch (const std::exception &e) {
-    std::cout << "Caught exception: '" << e.what() << "'\n";
-    return mlx_err::mlx_exception;
+    *res = static_cast<ArrayMap *>(map)->size();
+  } catch (...) {
+    return handle_exception(__func__);
   }
-  return mlx_err::mlx_success;
+  return mlx_success;
 }
 
-Dtype dtypeFromEnum(mlx_dtype dtype_enum) {
-  switch (dtype_enum) {
-  case mlx_dtype::bool_:
-    return mlx::core::bool_;
-  case mlx_dtype::uint8:
-    return mlx::core::uint8;
-  case mlx_dtype::uint16:
-    return mlx::core::uint16;
-  case mlx_dtype::uint32:
-    return mlx::core::uint32;
-  case mlx_dtype::uint64:
-    return mlx::core::uint64;
-  case mlx_dtype::int8:
-    return mlx::core::int8;
-  case mlx_dtype::int16:
-    return mlx::core::int16;
-  case mlx_dtype::int32:
-    return mlx::core::int32;
-  case mlx_dtype::int64:
-    return mlx::core::int64;
-  case mlx_dtype::float16:
-    return mlx::core::float16;
-  case mlx_dtype::float32:
-    return mlx::core::float32;
-  case mlx_dtype::bfloat16:
-    return mlx::core::bfloat16;
-  // TODO: case mlx_dtype::complex64:
-  default:
-    throw std::invalid_argument("Invalid dtype enum");
+mlx_err array_map_get(mlx_array *res, mlx_array_map map, const char *name) {
+  ProfileScope profile(__func__);
+  try {
+    auto m = static_cast<ArrayMap *>(map);
+    auto it = std::lower_bound(
+        m->begin(), m->end(), name,
+        [](const auto &entry, const char *key) { return entry.first < key; });
+    mlx_array new_array = nullptr;
+    if (it != m->end() && it->first == name) {
+      new_array = newHandle(it->second);
+    }
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
   }
+  return mlx_success;
 }
 
-mlx_dtype enumFromDtype(Dtype val) {
-  switch (val) {
-  case mlx::core::bool_:
-    return mlx_dtype::bool_;
-  case mlx::core::uint8:
-    return mlx_dtype::uint8;
-  case mlx::core::uint16:
-    return mlx_dtype::uint16;
-  case mlx::core::uint32:
-    return mlx_dtype::uint32;
-  case mlx::core::uint64:
-    return mlx_dtype::uint64;
-  case mlx::core::int8:
-    return mlx_dtype::int8;
-  case mlx::core::int16:
-    return mlx_dtype::int16;
-  case mlx::core::int32:
-    return mlx_dtype::int32;
-  case mlx::core::int64:
-    return mlx_dtype::int64;
-  case mlx::core::float16:
-    return mlx_dtype::float16;
-  case mlx::core::float32:
-    return mlx_dtype::float32;
-  case mlx::core::bfloat16:
-    return mlx_dtype::bfloat16;
-  // TODO: case mlx_dtype::complex64:
-  default:
-    throw std::invalid_argument("Invalid dtype enum");
+mlx_err array_map_entry(const char **name, mlx_array *res, mlx_array_map map,
+                        size_t idx) {
+  ProfileScope profile(__func__);
+  try {
+    auto &entry = static_cast<ArrayMap *>(map)->at(idx);
+    mlx_array new_array = newHandle(entry.second);
+    *name = entry.first.c_str();
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
   }
+  return mlx_success;
 }
 
-extern "C" {
+mlx_err save_safetensors(const char *path, const char *const *names,
+                         const mlx_array *arrs, size_t n) {
+  ProfileScope profile(__func__);
+  try {
+    std::vector<std::string> names_vec(names, names + n);
+    saveSafetensorsStreaming(path, names_vec, collectArrays(arrs, n));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err save_npy(const char *path, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    mlx::core::save(path, *static_cast<array *>(arr));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
 
-void destroyArray(mlx_array arr) { delete static_cast<array *>(arr); }
+void destroyGraph(mlx_graph graph) { delete static_cast<Graph *>(graph); }
 
-void destroyArrayIterator(mlx_array_iterator iter) {
-  delete static_cast<array::ArrayIterator*>(iter);
+mlx_err graph_build(mlx_graph *res, const mlx_array *outputs, size_t n) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_graph new_graph = new Graph(buildGraph(collectArrays(outputs, n)));
+    std::swap(*res, new_graph);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
 }
 
+mlx_err graph_size(size_t *res, mlx_graph graph) {
+  ProfileScope profile(__func__);
+  try {
+    *res = static_cast<Graph *>(graph)->nodes.size();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
 
-mlx_err seed(uint64_t seed) {
-  std::exception_ptr eptr;
+mlx_err graph_node(mlx_graph_node *res, mlx_graph graph, size_t idx) {
+  ProfileScope profile(__func__);
   try {
-    random::seed(seed);
+    auto g = static_cast<Graph *>(graph);
+    const auto &a = g->nodes.at(idx);
+    res->id = a.id();
+    res->primitive = primitiveName(a);
+    res->dtype = enumFromDtype(a.dtype());
+    res->ndim = a.ndim();
+    res->shape = g->shapes[idx].data();
+    res->nbytes = a.nbytes();
+    res->is_evaled = a.is_evaled();
+    res->n_inputs = g->inputs[idx].size();
+    res->inputs = g->inputs[idx].data();
+    res->live_bytes = g->live_bytes[idx];
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err graph_memory(mlx_graph_memory *res, mlx_graph graph) {
+  ProfileScope profile(__func__);
+  try {
+    auto g = static_cast<Graph *>(graph);
+    res->resident_bytes = g->resident_bytes;
+    res->pending_bytes = g->pending_bytes;
+    res->peak_bytes = g->peak_bytes;
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err graph_export(mlx_graph graph, const char *path,
+                     mlx_graph_format format) {
+  ProfileScope profile(__func__);
+  try {
+    auto g = static_cast<Graph *>(graph);
+    auto out = format == mlx_graph_dot ? graphToDot(*g) : graphToJson(*g);
+    std::unique_ptr<FILE, int (*)(FILE *)> file(std::fopen(path, "wb"),
+                                               &std::fclose);
+    if (!file) {
+      throw std::runtime_error(std::string("Failed to open ") + path);
+    }
+    if (std::fwrite(out.data(), 1, out.size(), file.get()) != out.size()) {
+      throw std::runtime_error(std::string("Failed to write ") + path);
+    }
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err nextDiff(mlx_array_iterator iter, size_t diff) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto i = static_cast<array::ArrayIterator *>(iter);
-    auto tmp = i + diff;
+    // ArrayIterator::operator+ advances the iterator in place
+    (*i) + diff;
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err next(mlx_array_iterator iter) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto i = static_cast<array::ArrayIterator *>(iter);
-    i++;
+    ++(*i);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err arrayIterEql(bool *res, mlx_array_iterator a, mlx_array_iterator b) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto iter_a = static_cast<array::ArrayIterator *>(a);
     auto iter_b = static_cast<array::ArrayIterator *>(b);
     *res = (*iter_a) == (*iter_b);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err arrayIterNeq(bool *res, mlx_array_iterator a, mlx_array_iterator b) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto iter_a = static_cast<array::ArrayIterator *>(a);
     auto iter_b = static_cast<array::ArrayIterator *>(b);
     *res = (*iter_a) != (*iter_b);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err fromScalar(mlx_array *res, double val, mlx_dtype dtype) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto arr = array(val, dtypeFromEnum(dtype));
-    mlx_array new_array = new array(arr);
+    mlx_array new_array = newHandle(arr);
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err fromScalarI64(mlx_array *res, int64_t val) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
-    mlx_array new_array = new array(val, mlx::core::int64);
+    mlx_array new_array = newHandle(array(val, mlx::core::int64));
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err fromScalarU64(mlx_array *res, uint64_t val) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
-    mlx_array new_array = new array(val, mlx::core::uint64);
+    mlx_array new_array = newHandle(array(val, mlx::core::uint64));
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err initHandle(mlx_array *res, const void *shape, size_t shape_len,
                    mlx_dtype dtype) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto shape_int = reinterpret_cast<const int *>(shape);
     std::vector<int> shape_vec(shape_int, shape_int + shape_len);
@@ -194,91 +2113,91 @@ mlx_err initHandle(mlx_array *res, const void *shape, size_t shape_len,
     const int product = std::accumulate(shape_vec.begin(), shape_vec.end(), 1,
                                         std::multiplies<int>());
     auto buffer = allocator::malloc(product * size_of(data_type));
-    mlx_array new_array = new array(buffer, shape_vec, data_type);
+    mlx_array new_array = newHandle(array(buffer, shape_vec, data_type));
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err initEmpty(mlx_array *res) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
-    mlx_array new_array = new array({});
+    mlx_array new_array = newHandle(array({}));
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err fromPtr(mlx_array *res, const void *data, const void *shape,
                 size_t shape_len, mlx_dtype dtype) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto shape_int = reinterpret_cast<const int *>(shape);
     std::vector<int> shape_vec(shape_int, shape_int + shape_len);
     mlx_array new_array;
     switch (dtype) {
     case mlx_dtype::bool_: {
-      new_array = new array(static_cast<const bool *>(data), shape_vec,
-                            mlx::core::bool_);
+      new_array = newHandle(array(static_cast<const bool *>(data),
+                                  shape_vec, mlx::core::bool_));
       break;
     }
     case mlx_dtype::uint8: {
-      new_array = new array(static_cast<const uint8_t *>(data), shape_vec,
-                            mlx::core::uint8);
+      new_array = newHandle(array(static_cast<const uint8_t *>(data),
+                                  shape_vec, mlx::core::uint8));
       break;
     }
     case mlx_dtype::uint16: {
-      new_array = new array(static_cast<const uint16_t *>(data), shape_vec,
-                            mlx::core::uint16);
+      new_array = newHandle(array(static_cast<const uint16_t *>(data),
+                                  shape_vec, mlx::core::uint16));
       break;
     }
     case mlx_dtype::uint32: {
-      new_array = new array(static_cast<const uint32_t *>(data), shape_vec,
-                            mlx::core::uint32);
+      new_array = newHandle(array(static_cast<const uint32_t *>(data),
+                                  shape_vec, mlx::core::uint32));
       break;
     }
     case mlx_dtype::uint64: {
-      new_array = new array(static_cast<const uint64_t *>(data), shape_vec,
-                            mlx::core::uint64);
+      new_array = newHandle(array(static_cast<const uint64_t *>(data),
+                                  shape_vec, mlx::core::uint64));
       break;
     }
     case mlx_dtype::int8: {
-      new_array = new array(static_cast<const int8_t *>(data), shape_vec,
-                            mlx::core::int8);
+      new_array = newHandle(array(static_cast<const int8_t *>(data),
+                                  shape_vec, mlx::core::int8));
       break;
     }
     case mlx_dtype::int16: {
-      new_array = new array(static_cast<const int16_t *>(data), shape_vec,
-                            mlx::core::int16);
+      new_array = newHandle(array(static_cast<const int16_t *>(data),
+                                  shape_vec, mlx::core::int16));
       break;
     }
     case mlx_dtype::int32: {
-      new_array = new array(static_cast<const int32_t *>(data), shape_vec,
-                            mlx::core::int32);
+      new_array = newHandle(array(static_cast<const int32_t *>(data),
+                                  shape_vec, mlx::core::int32));
       break;
     }
     case mlx_dtype::int64: {
-      new_array = new array(static_cast<const int64_t *>(data), shape_vec,
-                            mlx::core::int64);
+      new_array = newHandle(array(static_cast<const int64_t *>(data),
+                                  shape_vec, mlx::core::int64));
       break;
     }
     case mlx_dtype::float16: {
-      new_array = new array(static_cast<const float16_t *>(data), shape_vec,
-                            mlx::core::float16);
+      new_array = newHandle(array(static_cast<const float16_t *>(data),
+                                  shape_vec, mlx::core::float16));
       break;
     }
     case mlx_dtype::float32: {
-      new_array = new array(static_cast<const float *>(data), shape_vec,
-                            mlx::core::float32);
+      new_array = newHandle(array(static_cast<const float *>(data),
+                                  shape_vec, mlx::core::float32));
       break;
     }
     case mlx_dtype::bfloat16: {
-      new_array = new array(static_cast<const bfloat16_t *>(data), shape_vec,
-                            mlx::core::bfloat16);
+      new_array = newHandle(array(static_cast<const bfloat16_t *>(data),
+                                  shape_vec, mlx::core::bfloat16));
       break;
     }
     // TODO: case mlx_dtype::complex64:
@@ -289,133 +2208,460 @@ mlx_err fromPtr(mlx_array *res, const void *data, const void *shape,
     }
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err fromPtrNoCopy(mlx_array *res, void *data, const void *shape,
+                      size_t shape_len, mlx_dtype dtype, mlx_deleter deleter,
+                      void *ctx) {
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    auto type = dtypeFromEnum(dtype);
+    // MLX wraps `data` as the array's buffer; `deleter` runs once the last
+    // reference to that buffer is dropped (possibly on another thread).
+    auto release = [deleter, ctx](void *ptr) {
+      if (deleter != nullptr) {
+        deleter(ctx, ptr);
+      }
+    };
+    // The handle is allocated before `data` is wrapped: once the array
+    // exists, dropping it on a failed allocation would run `deleter` while
+    // the caller still owns `data`.
+    HandleMem mem = reserveHandle();
+    mlx_array new_array;
+    try {
+      new_array = placeHandle(mem, array(data, shape_vec, type, release));
+    } catch (...) {
+      unreserveHandle(mem);
+      throw;
+    }
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err fromPtrConvert(mlx_array *res, const void *data, const void *shape,
+                       size_t shape_len, mlx_dtype src_dtype,
+                       mlx_dtype dst_dtype) {
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    auto src_type = dtypeFromEnum(src_dtype);
+    auto dst_type = dtypeFromEnum(dst_dtype);
+    size_t count = std::accumulate(shape_vec.begin(), shape_vec.end(),
+                                   size_t(1), std::multiplies<size_t>());
+    auto buffer = allocator::malloc(count * size_of(dst_type));
+    try {
+      dispatchDtype(src_type, [&](auto src_tag) {
+        using S = decltype(src_tag);
+        dispatchDtype(dst_type, [&](auto dst_tag) {
+          using D = decltype(dst_tag);
+          convertContiguous(static_cast<const S *>(data),
+                            static_cast<D *>(buffer.raw_ptr()), count);
+        });
+      });
+    } catch (...) {
+      allocator::free(buffer);
+      throw;
+    }
+    mlx_array new_array = newHandle(array(buffer, shape_vec, dst_type));
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err randomNormal(mlx_array *res, const void *shape, size_t shape_len,
                      mlx_dtype dtype) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    std::lock_guard<std::mutex> lock(random_mutex);
+    auto arr = random::normal(shape_vec, dtypeFromEnum(dtype), std::nullopt,
+                              currentStream());
+    mlx_array new_array = newHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomKey(mlx_array *res, uint64_t seed) {
+  ProfileScope profile(__func__);
+  try {
+    mlx_array new_array = newHandle(random::key(seed));
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomSplit(mlx_array *res, size_t n, mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    if (n == 0) {
+      throw std::invalid_argument("Cannot split a key into zero keys");
+    }
+    auto keys = random::split(*static_cast<array *>(key), static_cast<int>(n),
+                              currentStream());
+    writeBatch(res, n, keys);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomNormalKey(mlx_array *res, const void *shape, size_t shape_len,
+                        mlx_dtype dtype, float loc, float scale,
+                        mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    auto lock = lockGlobalRandom(key);
+    auto arr = random::normal(shape_vec, dtypeFromEnum(dtype), loc, scale,
+                              optionalKey(key), currentStream());
+    mlx_array new_array = newHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomUniform(mlx_array *res, double low, double high,
+                      const void *shape, size_t shape_len, mlx_dtype dtype,
+                      mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    auto dt = dtypeFromEnum(dtype);
+    auto lock = lockGlobalRandom(key);
+    auto arr = random::uniform(array(low, dt), array(high, dt), shape_vec, dt,
+                               optionalKey(key), currentStream());
+    mlx_array new_array = newHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomBernoulli(mlx_array *res, double p, const void *shape,
+                        size_t shape_len, mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    auto shape_int = reinterpret_cast<const int *>(shape);
+    std::vector<int> shape_vec(shape_int, shape_int + shape_len);
+    auto lock = lockGlobalRandom(key);
+    auto arr = random::bernoulli(array(p, mlx::core::float32), shape_vec,
+                                 optionalKey(key), currentStream());
+    mlx_array new_array = newHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
 
+mlx_err randomRandint(mlx_array *res, int64_t low, int64_t high,
+                      const void *shape, size_t shape_len, mlx_dtype dtype,
+                      mlx_array key) {
+  ProfileScope profile(__func__);
   try {
     auto shape_int = reinterpret_cast<const int *>(shape);
     std::vector<int> shape_vec(shape_int, shape_int + shape_len);
-    auto arr = random::normal(shape_vec, dtypeFromEnum(dtype));
-    mlx_array new_array = new array(arr);
+    auto lock = lockGlobalRandom(key);
+    auto arr = random::randint(array(low, mlx::core::int64),
+                               array(high, mlx::core::int64),
+                               shape_vec, dtypeFromEnum(dtype),
+                               optionalKey(key), currentStream());
+    mlx_array new_array = newHandle(arr);
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomNormalBatch(mlx_array *res, size_t n, const void *shape,
+                          size_t shape_len, mlx_dtype dtype, mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    auto lock = lockGlobalRandom(key);
+    auto batch = random::normal(batchShape(n, shape, shape_len),
+                                dtypeFromEnum(dtype), optionalKey(key),
+                                currentStream());
+    writeBatch(res, n, batch);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err randomUniformBatch(mlx_array *res, size_t n, double low, double high,
+                           const void *shape, size_t shape_len,
+                           mlx_dtype dtype, mlx_array key) {
+  ProfileScope profile(__func__);
+  try {
+    auto dt = dtypeFromEnum(dtype);
+    auto lock = lockGlobalRandom(key);
+    auto batch = random::uniform(array(low, dt), array(high, dt),
+                                 batchShape(n, shape, shape_len), dt,
+                                 optionalKey(key), currentStream());
+    writeBatch(res, n, batch);
+  } catch (...) {
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err itemsize(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->itemsize();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err size(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->size();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err nbytes(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->nbytes();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err ndim(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->ndim();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err shape(void **res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
-    std::vector<int> a_shape = a->shape();
-    *res = a_shape.data();
+    // points into the array's own metadata, valid while `arr` is alive
+    const auto &a_shape = a->shape();
+    *res = const_cast<void *>(static_cast<const void *>(a_shape.data()));
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err dim(int *res, int dimension, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->shape(dimension);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err strides(void **res, size_t *stride_len, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
-    std::vector<size_t> a_strides = a->strides();
+    // points into the array's own metadata, valid while `arr` is alive
+    const auto &a_strides = a->strides();
     *stride_len = a_strides.size();
-    *res = a_strides.data();
+    // MLX strides are signed 64-bit integers and may be negative
+    *res = const_cast<void *>(static_cast<const void *>(a_strides.data()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err describe(mlx_array_desc *res, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    res->dtype = enumFromDtype(a->dtype());
+    res->ndim = a->ndim();
+    res->size = a->size();
+    res->nbytes = a->nbytes();
+    res->itemsize = a->itemsize();
+    res->is_evaled = a->is_evaled();
+    auto flags = a->flags();
+    res->flags.contiguous = flags.contiguous;
+    res->flags.row_contiguous = flags.row_contiguous;
+    res->flags.col_contiguous = flags.col_contiguous;
+    if (res->ndim > res->capacity) {
+      throw std::out_of_range("Array has more dimensions than desc capacity");
+    }
+    const auto &a_shape = a->shape();
+    std::copy(a_shape.begin(), a_shape.end(), res->shape);
+    const auto &a_strides = a->strides();
+    std::copy(a_strides.begin(), a_strides.end(), res->strides);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err dtype(mlx_dtype *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = enumFromDtype(a->dtype());
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err eval_array(bool retain_graph, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    size_t pending = 0;
+    evalShared({*a}, retain_graph, profile.active() ? &pending : nullptr);
+    profile.setGraphNodes(pending);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err eval_many(const mlx_array *arrs, size_t n) {
+  ProfileScope profile(__func__);
+  try {
+    auto outputs = collectArrays(arrs, n);
+    size_t pending = 0;
+    evalShared(std::move(outputs), false,
+               profile.active() ? &pending : nullptr);
+    profile.setGraphNodes(pending);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err async_eval(mlx_future *res, const mlx_array *arrs, size_t n) {
+  ProfileScope profile(__func__);
+  try {
+    auto fut = std::make_unique<Future>();
+    fut->outputs = collectArrays(arrs, n);
+    {
+      std::lock_guard<std::mutex> lock(eval_mutex);
+      if (profile.active()) {
+        profile.setGraphNodes(pendingNodes(fut->outputs).size());
+      }
+      mlx::core::async_eval(fut->outputs);
+    }
+    mlx_future new_future = fut.release();
+    std::swap(*res, new_future);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err future_wait(mlx_future fut) {
+  ProfileScope profile(__func__);
+  try {
+    auto f = static_cast<Future *>(fut);
+    size_t pending = 0;
+    evalShared(f->outputs, false, profile.active() ? &pending : nullptr);
+    profile.setGraphNodes(pending);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err future_is_ready(bool *res, mlx_future fut) {
+  ProfileScope profile(__func__);
+  try {
+    auto f = static_cast<Future *>(fut);
+    *res = std::all_of(f->outputs.begin(), f->outputs.end(),
+                       [](const array &a) { return a.is_available(); });
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err copy_to(mlx_array arr, void *dst, mlx_dtype dst_dtype,
+                mlx_layout layout) {
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
-    a->eval(retain_graph);
+    evalShared({*a});
+    auto out_dtype = dtypeFromEnum(dst_dtype);
+    auto flags = a->flags();
+    bool dense = layout == mlx_layout::mlx_row_major ? flags.row_contiguous
+                                                      : flags.col_contiguous;
+    if (dense && out_dtype == a->dtype()) {
+      std::memcpy(dst, a->data<char>(), a->nbytes());
+      return mlx_success;
+    }
+    std::vector<int> shape_vec(a->shape().begin(), a->shape().end());
+    std::vector<int64_t> strides_vec(a->strides().begin(),
+                                     a->strides().end());
+    if (layout == mlx_layout::mlx_col_major) {
+      // column-major output is the row-major walk of the reversed axes
+      std::reverse(shape_vec.begin(), shape_vec.end());
+      std::reverse(strides_vec.begin(), strides_vec.end());
+    }
+    dispatchDtype(a->dtype(), [&](auto src_tag) {
+      using S = decltype(src_tag);
+      dispatchDtype(out_dtype, [&](auto dst_tag) {
+        using D = decltype(dst_tag);
+        gatherConvert(a->data<S>(), static_cast<D *>(dst), shape_vec,
+                      strides_vec);
+      });
+    });
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err item(void *res, bool retain_graph, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
+    evalShared({*a}, retain_graph);
     switch (a->dtype()) {
     case mlx::core::bool_: {
       *(static_cast<bool *>(res)) = a->item<bool>(retain_graph);
@@ -471,85 +2717,188 @@ mlx_err item(void *res, bool retain_graph, mlx_array arr) {
     }
     }
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err begin(mlx_array_iterator *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     array::ArrayIterator *iter = new array::ArrayIterator(*a);
     *res = iter;
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err end(mlx_array_iterator *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     array::ArrayIterator *iter = new array::ArrayIterator(*a, a->shape(0));
     *res = iter;
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err split_chunks(mlx_array *res, size_t n, mlx_array arr, int chunk_size,
+                     bool eval) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    if (chunk_size <= 0) {
+      throw std::invalid_argument("Chunk size must be positive");
+    }
+    int rows = a->shape(0);
+    std::vector<int> indices;
+    for (int i = chunk_size; i < rows; i += chunk_size) {
+      indices.push_back(i);
+    }
+    if (n != indices.size() + 1) {
+      throw std::invalid_argument("Result capacity does not match the number "
+                                  "of chunks");
+    }
+    auto parts = mlx::core::split(*a, indices, 0, currentStream());
+    if (eval) {
+      evalShared(parts);
+    }
+    newHandles(res, parts);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err split_indices(mlx_array *res, mlx_array arr, const int *indices,
+                      size_t n_indices, bool eval) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    std::vector<int> indices_vec(indices, indices + n_indices);
+    auto parts = mlx::core::split(*a, indices_vec, 0, currentStream());
+    if (eval) {
+      evalShared(parts);
+    }
+    newHandles(res, parts);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err id(size_t *res, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    *res = a->id();
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err primitive(mlx_primitive *res, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    *res = &(a->primitive());
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err has_primitive(bool *res, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    *res = a->has_primitive();
+  } catch (...) {
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
-mlx_err id(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+mlx_err primitive_name(const char **res, mlx_array arr) {
+  ProfileScope profile(__func__);
   try {
-    auto a = static_cast<array *>(arr);
-    *res = a->id();
+    *res = primitiveName(*static_cast<array *>(arr));
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
-mlx_err primitive(mlx_primitive *res, mlx_array arr) {
-  std::exception_ptr eptr;
+mlx_err num_inputs(size_t *res, mlx_array arr) {
+  ProfileScope profile(__func__);
   try {
-    auto a = static_cast<array *>(arr);
-    *res = &(a->primitive());
+    *res = static_cast<array *>(arr)->inputs().size();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
-mlx_err has_primitive(bool *res, mlx_array arr) {
-  std::exception_ptr eptr;
+mlx_err inputs(mlx_array *res, size_t n, mlx_array arr) {
+  ProfileScope profile(__func__);
   try {
-    auto a = static_cast<array *>(arr);
-    *res = a->has_primitive();
+    const auto &ins = static_cast<array *>(arr)->inputs();
+    if (n != ins.size()) {
+      throw std::invalid_argument("Result capacity does not match the number "
+                                  "of inputs");
+    }
+    newHandles(res, ins);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
-// TODO: mlx_err inputs() {}
-
-// TODO: mlx_err editable_inputs() {}
+mlx_err editable_inputs(mlx_array *res, size_t n, mlx_array arr) {
+  ProfileScope profile(__func__);
+  try {
+    auto &ins = static_cast<array *>(arr)->editable_inputs();
+    if (n != ins.size()) {
+      throw std::invalid_argument("Result capacity does not match the number "
+                                  "of inputs");
+    }
+    std::vector<mlx_array> handles;
+    handles.reserve(n);
+    try {
+      for (size_t i = 0; i < n; ++i) {
+        handles.push_back(borrowedHandle(ins[i]));
+      }
+    } catch (...) {
+      for (auto h : handles) {
+        releaseHandle(h);
+      }
+      throw;
+    }
+    std::copy(handles.begin(), handles.end(), res);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
 
 mlx_err detach(mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     a->detach();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err flags(mlx_array_flags *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     auto flags = a->flags();
@@ -557,24 +2906,24 @@ mlx_err flags(mlx_array_flags *res, mlx_array arr) {
     res->row_contiguous = flags.row_contiguous;
     res->col_contiguous = flags.col_contiguous;
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err data_size(size_t *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->data_size();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err data(void **res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     void *dptr;
@@ -634,85 +2983,675 @@ mlx_err data(void **res, mlx_array arr) {
     }
     std::swap(*res, dptr);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err is_evaled(bool *res, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     *res = a->is_evaled();
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err set_tracer(bool is_tracer, mlx_array arr) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto a = static_cast<array *>(arr);
     a->set_tracer(is_tracer);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err add(mlx_array *res, mlx_array lhs, mlx_array rhs) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto lhs_array = static_cast<array *>(lhs);
     auto rhs_array = static_cast<array *>(rhs);
-    array tmp = mlx::core::add(*lhs_array, *rhs_array);
-    *res = new array(tmp);
+    array tmp = mlx::core::add(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err subtract(mlx_array *res, mlx_array lhs, mlx_array rhs) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto lhs_array = static_cast<array *>(lhs);
     auto rhs_array = static_cast<array *>(rhs);
-    auto tmp = mlx::core::subtract(*lhs_array, *rhs_array);
-    mlx_array new_array = new array(tmp);
+    auto tmp = mlx::core::subtract(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err multiply(mlx_array *res, mlx_array lhs, mlx_array rhs) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
   try {
     auto lhs_array = static_cast<array *>(lhs);
     auto rhs_array = static_cast<array *>(rhs);
-    auto tmp = mlx::core::multiply(*lhs_array, *rhs_array);
-    mlx_array new_array = new array(tmp);
+    auto tmp = mlx::core::multiply(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 
 mlx_err divide(mlx_array *res, mlx_array lhs, mlx_array rhs) {
-  std::exception_ptr eptr;
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    auto tmp = mlx::core::divide(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err add_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                   mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::add(scalar, *a, currentStream())
+                   : mlx::core::add(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err subtract_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::subtract(scalar, *a, currentStream())
+                   : mlx::core::subtract(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err multiply_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::multiply(scalar, *a, currentStream())
+                   : mlx::core::multiply(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err divide_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                      mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::divide(scalar, *a, currentStream())
+                   : mlx::core::divide(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+// The `*_into` ops assign the result to `res`. That drops `res`'s old value;
+// if it was an input it is then only referenced by the graph, so MLX can
+// donate its buffer to the output.
+mlx_err add_into(mlx_array res, mlx_array lhs, mlx_array rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    assignHandle(res,
+                 mlx::core::add(*lhs_array, *rhs_array, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err subtract_into(mlx_array res, mlx_array lhs, mlx_array rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    assignHandle(res,
+                 mlx::core::subtract(*lhs_array, *rhs_array, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err multiply_into(mlx_array res, mlx_array lhs, mlx_array rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    assignHandle(res,
+                 mlx::core::multiply(*lhs_array, *rhs_array, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err divide_into(mlx_array res, mlx_array lhs, mlx_array rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    assignHandle(res,
+                 mlx::core::divide(*lhs_array, *rhs_array, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err add_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    assignHandle(res, side == mlx_operator_side::mlx_lhs
+                          ? mlx::core::add(scalar, *a, currentStream())
+                          : mlx::core::add(*a, scalar, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err subtract_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                             mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    assignHandle(res, side == mlx_operator_side::mlx_lhs
+                          ? mlx::core::subtract(scalar, *a, currentStream())
+                          : mlx::core::subtract(*a, scalar, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err multiply_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                             mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    assignHandle(res, side == mlx_operator_side::mlx_lhs
+                          ? mlx::core::multiply(scalar, *a, currentStream())
+                          : mlx::core::multiply(*a, scalar, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err divide_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                           mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    assignHandle(res, side == mlx_operator_side::mlx_lhs
+                          ? mlx::core::divide(scalar, *a, currentStream())
+                          : mlx::core::divide(*a, scalar, currentStream()));
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err add_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                    bool consume_lhs, bool consume_rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    auto tmp = mlx::core::add(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    releaseInputs(lhs, consume_lhs, rhs, consume_rhs);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err subtract_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                         bool consume_lhs, bool consume_rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    auto tmp = mlx::core::subtract(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    releaseInputs(lhs, consume_lhs, rhs, consume_rhs);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err multiply_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                         bool consume_lhs, bool consume_rhs) {
+  ProfileScope profile(__func__);
+  try {
+    auto lhs_array = static_cast<array *>(lhs);
+    auto rhs_array = static_cast<array *>(rhs);
+    auto tmp = mlx::core::multiply(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    releaseInputs(lhs, consume_lhs, rhs, consume_rhs);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err divide_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                       bool consume_lhs, bool consume_rhs) {
+  ProfileScope profile(__func__);
   try {
     auto lhs_array = static_cast<array *>(lhs);
     auto rhs_array = static_cast<array *>(rhs);
-    auto tmp = mlx::core::divide(*lhs_array, *rhs_array);
-    mlx_array new_array = new array(tmp);
+    auto tmp = mlx::core::divide(*lhs_array, *rhs_array, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    releaseInputs(lhs, consume_lhs, rhs, consume_rhs);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err add_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                           mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::add(scalar, *a, currentStream())
+                   : mlx::core::add(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    consumeHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err subtract_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                                mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::subtract(scalar, *a, currentStream())
+                   : mlx::core::subtract(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    consumeHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err multiply_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                                mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::multiply(scalar, *a, currentStream())
+                   : mlx::core::multiply(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    consumeHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err divide_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                              mlx_operator_side side) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto scalar = scalarArray(val, scalarDtype(*a, val));
+    auto tmp = side == mlx_operator_side::mlx_lhs
+                   ? mlx::core::divide(scalar, *a, currentStream())
+                   : mlx::core::divide(*a, scalar, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    consumeHandle(arr);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err slice(mlx_array *res, mlx_array arr, const int *start,
+              const int *stop, const int *strides, size_t n) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::slice(
+        *static_cast<array *>(arr), std::vector<int>(start, start + n),
+        std::vector<int>(stop, stop + n),
+        std::vector<int>(strides, strides + n), currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err reshape(mlx_array *res, mlx_array arr, const int *shape,
+                size_t shape_len) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::reshape(*static_cast<array *>(arr),
+                                  std::vector<int>(shape, shape + shape_len),
+                                  currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err transpose(mlx_array *res, mlx_array arr, const int *axes,
+                  size_t n_axes) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto tmp = n_axes == 0 ? mlx::core::transpose(*a, currentStream())
+                           : mlx::core::transpose(
+                                 *a, std::vector<int>(axes, axes + n_axes),
+                                 currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err expand_dims(mlx_array *res, mlx_array arr, const int *axes,
+                    size_t n_axes) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::expand_dims(*static_cast<array *>(arr),
+                                      std::vector<int>(axes, axes + n_axes),
+                                      currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err squeeze(mlx_array *res, mlx_array arr, const int *axes,
+                size_t n_axes) {
+  ProfileScope profile(__func__);
+  try {
+    auto a = static_cast<array *>(arr);
+    auto tmp = n_axes == 0 ? mlx::core::squeeze(*a, currentStream())
+                           : mlx::core::squeeze(
+                                 *a, std::vector<int>(axes, axes + n_axes),
+                                 currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err broadcast_to(mlx_array *res, mlx_array arr, const int *shape,
+                     size_t shape_len) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::broadcast_to(
+        *static_cast<array *>(arr), std::vector<int>(shape, shape + shape_len),
+        currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err as_strided(mlx_array *res, mlx_array arr, const int *shape,
+                   const int64_t *strides, size_t ndim, size_t offset) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::as_strided(
+        *static_cast<array *>(arr), std::vector<int>(shape, shape + ndim),
+        Strides(strides, strides + ndim), offset, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err concatenate(mlx_array *res, const mlx_array *arrs, size_t n,
+                    int axis) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::concatenate(collectArrays(arrs, n), axis,
+                                      currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err stack(mlx_array *res, const mlx_array *arrs, size_t n, int axis) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::stack(collectArrays(arrs, n), axis, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err dispatch_batch(mlx_array *res, const mlx_op_desc *ops, size_t n,
+                       bool eval) {
+  ProfileScope profile(__func__);
+  try {
+    std::vector<array> results;
+    results.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+      const auto &desc = ops[i];
+      auto lhs = batchOperand(desc.lhs, results);
+      auto rhs = batchOperand(desc.rhs, results);
+      if (!lhs && !rhs) {
+        throw std::invalid_argument("Batched op has no array operand");
+      }
+      if (!lhs) {
+        lhs = scalarArray(desc.lhs.val, scalarDtype(*rhs, desc.lhs.val));
+      } else if (!rhs) {
+        rhs = scalarArray(desc.rhs.val, scalarDtype(*lhs, desc.rhs.val));
+      }
+      results.push_back(binaryOp(desc.op, *lhs, *rhs));
+    }
+    if (eval) {
+      size_t pending = 0;
+      evalShared(results, false, profile.active() ? &pending : nullptr);
+      profile.setGraphNodes(pending);
+    }
+    newHandles(res, results);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err matmul(mlx_array *res, mlx_array a, mlx_array b) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::matmul(*static_cast<array *>(a),
+                                 *static_cast<array *>(b), currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err addmm(mlx_array *res, mlx_array c, mlx_array a, mlx_array b,
+              float alpha, float beta) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::addmm(
+        *static_cast<array *>(c), *static_cast<array *>(a),
+        *static_cast<array *>(b), alpha, beta, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err linear(mlx_array *res, mlx_array x, mlx_array w, mlx_array b) {
+  ProfileScope profile(__func__);
+  try {
+    // `swapaxes` only swaps strides; the GEMM reads `w` in place as a
+    // transposed operand, and `addmm` hands the bias to it as C with
+    // beta = 1, so neither `w.T` nor a broadcast bias is ever materialized.
+    auto &in = *static_cast<array *>(x);
+    auto wt = mlx::core::swapaxes(*static_cast<array *>(w), -1, -2,
+                                  currentStream());
+    auto tmp = b == nullptr
+                   ? mlx::core::matmul(in, wt, currentStream())
+                   : mlx::core::addmm(*static_cast<array *>(b), in, wt, 1.0f,
+                                      1.0f, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err quantize(mlx_array *res_w, mlx_array *res_scales,
+                 mlx_array *res_biases, mlx_array w, int group_size,
+                 int bits) {
+  ProfileScope profile(__func__);
+  try {
+    auto [wq, scales, biases] = mlx::core::quantize(
+        *static_cast<array *>(w), group_size, bits, currentStream());
+    std::unique_ptr<void, void (*)(void *)> new_w(newHandle(wq),
+                                                  &releaseHandle);
+    std::unique_ptr<void, void (*)(void *)> new_scales(newHandle(scales),
+                                                       &releaseHandle);
+    mlx_array new_biases = newHandle(biases);
+    *res_w = new_w.release();
+    *res_scales = new_scales.release();
+    *res_biases = new_biases;
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err dequantize(mlx_array *res, mlx_array w, mlx_array scales,
+                   mlx_array biases, int group_size, int bits) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::dequantize(
+        *static_cast<array *>(w), *static_cast<array *>(scales),
+        *static_cast<array *>(biases), group_size, bits, currentStream());
+    mlx_array new_array = newHandle(tmp);
+    std::swap(*res, new_array);
+  } catch (...) {
+    return handle_exception(__func__);
+  }
+  return mlx_success;
+}
+
+mlx_err quantized_matmul(mlx_array *res, mlx_array x, mlx_array w,
+                         mlx_array scales, mlx_array biases, bool transpose,
+                         int group_size, int bits) {
+  ProfileScope profile(__func__);
+  try {
+    auto tmp = mlx::core::quantized_matmul(
+        *static_cast<array *>(x), *static_cast<array *>(w),
+        *static_cast<array *>(scales), *static_cast<array *>(biases),
+        transpose, group_size, bits, currentStream());
+    mlx_array new_array = newHandle(tmp);
     std::swap(*res, new_array);
   } catch (...) {
-    eptr = std::current_exception(); // capture
+    return handle_exception(__func__);
   }
-  return handle_eptr(eptr);
+  return mlx_success;
 }
 }
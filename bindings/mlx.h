@@ -5,13 +5,130 @@
 
 #include "mlx_types.h"
 
+// Thread safety: every binding may be called concurrently from any number of
+// threads, provided a handle is not destroyed or written through (`*_into`,
+// `editable_inputs`, ...) while another thread uses it. Concurrent evals may
+// share inputs, including unevaluated subgraphs: graph scheduling is
+// serialized while computation runs in parallel, except for evals with
+// `retain_graph` set, which compute under the lock. Random bindings without an
+// explicit key share MLX's global key sequence and serialize on it; give each
+// thread its own key (`randomSplit`) for lock-free, reproducible sampling.
+// Calls to compiled functions (`compiled_call`) are serialized process-wide,
+// cache hits included: MLX looks up, traces and fills its compile cache in
+// one step that cannot be split; evaluating their outputs is not serialized.
+// Errors, arenas and pushed streams are per thread.
+
 // Methods to free underlying memory
 void destroyArray(mlx_array arr);
 void destroyArrayIterator(mlx_array_iterator iter);
+void destroyFuture(mlx_future fut);
+void destroyStream(mlx_stream stream);
+void destroyArrayMap(mlx_array_map map);
+void destroyCompiled(mlx_compiled compiled);
+void destroyGraph(mlx_graph graph);
+
+// Thread-local error reporting
+void mlx_last_error(mlx_error_info *res);
+void mlx_clear_error(void);
+
+// Opt-in profiling. While enabled, every binding call records its latency and
+// the growth in MLX's active memory, and eval bindings the size of the graph
+// they compute. Disabled, a binding pays one relaxed atomic load. Stats are
+// listed in first-call order; `mlx_profile_save_trace` writes the recorded
+// calls as a Chrome trace (chrome://tracing, Perfetto). The trace keeps the
+// latest 2^20 calls; older ones are counted in `otherData.dropped_events`.
+void mlx_profile_enable(bool enabled);
+bool mlx_profile_enabled(void);
+void mlx_profile_reset(void);
+mlx_err mlx_profile_size(size_t *res);
+mlx_err mlx_profile_stat_at(mlx_profile_stat *res, size_t idx);
+mlx_err mlx_profile_save_trace(const char *path);
+
+// Arenas for array handles. While an arena is pushed on the calling thread,
+// every binding returning an array places the handle in it; `destroyArray` is
+// a no-op for such handles (from any thread, and after the arena is popped)
+// and `mlx_arena_reset` releases them in bulk. `mlx_arena_destroy` also
+// removes the arena from the calling thread's stack; it must not be pushed on
+// any other thread.
+mlx_err mlx_arena_create(mlx_arena *res, size_t slab_size);
+void mlx_arena_destroy(mlx_arena arena);
+mlx_err mlx_arena_reset(mlx_arena arena);
+mlx_err mlx_arena_push(mlx_arena arena);
+mlx_err mlx_arena_pop(mlx_arena arena);
+// Returns a new heap-allocated handle sharing `arr`'s data.
+mlx_err cloneHandle(mlx_array *res, mlx_array arr);
+
+// Inline array storage. These construct an array in caller-owned storage
+// (on the stack, in a contiguous slice, ...) instead of behind a heap handle;
+// `(mlx_array)&storage` can then be passed to every binding, and the `*_into`
+// ops write their results into it without allocating a handle. Storage is
+// tagged as such: `destroyArray` ignores it, just like arena handles, and
+// consuming ops (`*_consume`) leave it holding an empty array. `copy` shares
+// `src`, `move` leaves `src` empty (it must still be destroyed), and `take`
+// also frees the heap handle `src`. Constructed storage may be relocated
+// bitwise but must be released with `array_storage_destroy`.
+mlx_err array_storage_copy(mlx_array_storage *dst, mlx_array src);
+mlx_err array_storage_move(mlx_array_storage *dst, mlx_array src);
+mlx_err array_storage_take(mlx_array_storage *dst, mlx_array src);
+void array_storage_destroy(mlx_array_storage *storage);
+
+// Streams. While a stream is pushed on the calling thread, every op binding
+// issued from that thread runs on it instead of MLX's default stream.
+mlx_err new_cpu_stream(mlx_stream *res);
+mlx_err default_cpu_stream(mlx_stream *res);
+mlx_err set_default_stream(mlx_stream stream);
+mlx_err synchronize(mlx_stream stream);
+mlx_err stream_push(mlx_stream stream);
+mlx_err stream_pop(mlx_stream stream);
 
 // Seed the random number generator.
 mlx_err seed(uint64_t seed);
 
+// Allocator and buffer cache instrumentation. The limit setters write the
+// previous limit to `res`.
+mlx_err get_active_memory(size_t *res);
+mlx_err get_peak_memory(size_t *res);
+mlx_err get_cache_memory(size_t *res);
+mlx_err reset_peak_memory(void);
+mlx_err set_memory_limit(size_t *res, size_t limit);
+mlx_err set_cache_limit(size_t *res, size_t limit);
+mlx_err clear_cache(void);
+
+// Compiled functions. `fn` is traced once per input shape/dtype signature
+// (once overall if `shapeless`) and its elementwise chains are fused. It must
+// write `n_outputs` new handles, which the bindings take ownership of.
+mlx_err compile_fn(mlx_compiled *res, mlx_closure_fn fn, void *ctx,
+                   size_t n_outputs, bool shapeless);
+mlx_err compiled_call(mlx_array *outputs, size_t n_outputs,
+                      mlx_compiled compiled, const mlx_array *inputs,
+                      size_t n_inputs);
+
+// Loading and saving. Loads memory-map the file and wrap the tensors in place
+// (copying only tensors misaligned for their dtype), so data is paged in on
+// first use. `save_safetensors` evaluates and writes one array at a time.
+mlx_err load_safetensors(mlx_array_map *res, const char *path);
+mlx_err load_npy(mlx_array *res, const char *path);
+mlx_err save_safetensors(const char *path, const char *const *names,
+                         const mlx_array *arrs, size_t n);
+mlx_err save_npy(const char *path, mlx_array arr);
+// Name -> array maps, sorted by name. `array_map_get` sets `*res` to NULL if
+// `name` is missing; names returned by `array_map_entry` live as long as the
+// map.
+mlx_err array_map_size(size_t *res, mlx_array_map map);
+mlx_err array_map_get(mlx_array *res, mlx_array_map map, const char *name);
+mlx_err array_map_entry(const char **name, mlx_array *res, mlx_array_map map,
+                        size_t idx);
+
+// Graph introspection. `graph_build` snapshots every array reachable from
+// `outputs`, inputs first, without evaluating anything; `graph_export` writes
+// the nodes and memory estimate as Graphviz DOT or JSON.
+mlx_err graph_build(mlx_graph *res, const mlx_array *outputs, size_t n);
+mlx_err graph_size(size_t *res, mlx_graph graph);
+mlx_err graph_node(mlx_graph_node *res, mlx_graph graph, size_t idx);
+mlx_err graph_memory(mlx_graph_memory *res, mlx_graph graph);
+mlx_err graph_export(mlx_graph graph, const char *path,
+                     mlx_graph_format format);
+
 // array::ArrayIterator methods
 mlx_err nextDiff(mlx_array_iterator iter, size_t diff);
 mlx_err next(mlx_array_iterator iter);
@@ -27,9 +144,47 @@ mlx_err initHandle(mlx_array *res, const void *shape, size_t shape_len,
 mlx_err initEmpty(mlx_array *res);
 mlx_err fromPtr(mlx_array *res, const void *data, const void *shape,
                 size_t shape_len, mlx_dtype dtype);
+// Wraps `data` as the array's storage without copying. `deleter(ctx, data)`
+// is invoked once MLX drops the last reference to the buffer. On error the
+// deleter is not invoked and `data` stays with the caller.
+mlx_err fromPtrNoCopy(mlx_array *res, void *data, const void *shape,
+                      size_t shape_len, mlx_dtype dtype, mlx_deleter deleter,
+                      void *ctx);
+// Like `fromPtr`, but `data` holds `src_dtype` elements that are converted to
+// `dst_dtype` while being copied into the array's single allocation (e.g.
+// f32 input stored as bf16/f16 without an intermediate f32 array).
+mlx_err fromPtrConvert(mlx_array *res, const void *data, const void *shape,
+                       size_t shape_len, mlx_dtype src_dtype,
+                       mlx_dtype dst_dtype);
 mlx_err randomNormal(mlx_array *res, const void *shape, size_t shape_len,
                      mlx_dtype dtype);
 
+// Key-based random generation. A key (from `randomKey` or `randomSplit`) fully
+// determines the samples drawn with it, so threads holding their own keys get
+// reproducible results without touching MLX's global random state; passing a
+// NULL key falls back to that global state.
+mlx_err randomKey(mlx_array *res, uint64_t seed);
+// Writes `n` independent keys derived from `key` to `res`.
+mlx_err randomSplit(mlx_array *res, size_t n, mlx_array key);
+mlx_err randomNormalKey(mlx_array *res, const void *shape, size_t shape_len,
+                        mlx_dtype dtype, float loc, float scale,
+                        mlx_array key);
+mlx_err randomUniform(mlx_array *res, double low, double high,
+                      const void *shape, size_t shape_len, mlx_dtype dtype,
+                      mlx_array key);
+mlx_err randomBernoulli(mlx_array *res, double p, const void *shape,
+                        size_t shape_len, mlx_array key);
+mlx_err randomRandint(mlx_array *res, int64_t low, int64_t high,
+                      const void *shape, size_t shape_len, mlx_dtype dtype,
+                      mlx_array key);
+// Draw `n` independent sample arrays of `shape` in a single generation pass,
+// writing one handle per sample to `res`.
+mlx_err randomNormalBatch(mlx_array *res, size_t n, const void *shape,
+                          size_t shape_len, mlx_dtype dtype, mlx_array key);
+mlx_err randomUniformBatch(mlx_array *res, size_t n, double low, double high,
+                           const void *shape, size_t shape_len,
+                           mlx_dtype dtype, mlx_array key);
+
 // Methods to get array properties
 mlx_err itemsize(size_t *res, mlx_array arr);
 mlx_err size(size_t *res, mlx_array arr);
@@ -37,20 +192,58 @@ mlx_err nbytes(size_t *res, mlx_array arr);
 mlx_err ndim(size_t *res, mlx_array arr);
 mlx_err shape(void **res, mlx_array arr);
 mlx_err dim(int *res, int dimension, mlx_array arr);
+// `res` points to `stride_len` signed 64-bit strides, in elements; only valid
+// for evaluated arrays (see `describe`).
 mlx_err strides(void **res, size_t *stride_len, mlx_array arr);
 mlx_err dtype(mlx_dtype *res, mlx_array arr);
+// Fills all of the above in a single call. If the array has more than
+// `res->capacity` dimensions, every field but `shape`/`strides` is filled and
+// `mlx_out_of_range` is returned. Nothing is evaluated: `strides` and `flags`
+// (like the `strides` and `flags` bindings) describe the actual layout only
+// once `is_evaled` is true.
+mlx_err describe(mlx_array_desc *res, mlx_array arr);
 
 // Other array methods
+// With `retain_graph`, evaluated arrays keep their inputs (and `arr` stays
+// differentiable); such evals are serialized with all other evals.
 mlx_err eval_array(bool retain_graph, mlx_array arr);
+// Evaluates `n` arrays in a single graph traversal.
+mlx_err eval_many(const mlx_array *arrs, size_t n);
+// Schedules evaluation of `n` arrays and returns without waiting.
+mlx_err async_eval(mlx_future *res, const mlx_array *arrs, size_t n);
+mlx_err future_wait(mlx_future fut);
+mlx_err future_is_ready(bool *res, mlx_future fut);
+// Evaluates `arr` and writes it to `dst` as a dense array of `dst_dtype` in
+// the given layout, reading any strided/broadcast view directly.
+mlx_err copy_to(mlx_array arr, void *dst, mlx_dtype dst_dtype,
+                mlx_layout layout);
 mlx_err item(void *res, bool retain_graph, mlx_array arr);
 mlx_err begin(mlx_array_iterator *res, mlx_array arr);
 mlx_err end(mlx_array_iterator *res, mlx_array arr);
+// Split `arr` along axis 0 into `n` views of `chunk_size` rows (the last may
+// be shorter); `n` must equal ceil(shape(0) / chunk_size). Like every binding
+// writing several handles, nothing is written to `res` on error.
+mlx_err split_chunks(mlx_array *res, size_t n, mlx_array arr, int chunk_size,
+                     bool eval);
+// Split `arr` along axis 0 before each of the `n_indices` row indices, writing
+// `n_indices + 1` views to `res`.
+mlx_err split_indices(mlx_array *res, mlx_array arr, const int *indices,
+                      size_t n_indices, bool eval);
 mlx_err id(size_t *res, mlx_array arr);
 mlx_err primitive(mlx_primitive *res, mlx_array arr);
 mlx_err has_primitive(bool *res, mlx_array arr);
-// TODO: mlx_err inputs();
-// TODO: mlx_err editable_inputs();
+// Name of the primitive producing `arr`; NULL for leaves.
+mlx_err primitive_name(const char **res, mlx_array arr);
+mlx_err num_inputs(size_t *res, mlx_array arr);
+// Writes new handles to the `n` (== `num_inputs`) inputs of `arr`.
+mlx_err inputs(mlx_array *res, size_t n, mlx_array arr);
+// Writes new handles to the input slots of `arr`: each reads as the input,
+// and assigning through it with an `*_into` op also replaces the input,
+// rewiring the graph. Destroy them like any handle; do not assign through
+// them once `arr` is destroyed, detached or evaluated.
+mlx_err editable_inputs(mlx_array *res, size_t n, mlx_array arr);
 mlx_err detach(mlx_array arr);
+// Like `strides`, only meaningful once `arr` is evaluated (see `describe`).
 mlx_err flags(mlx_array_flags *res, mlx_array arr);
 mlx_err data_size(size_t *res, mlx_array arr);
 mlx_err data(void **res, mlx_array arr);
@@ -61,4 +254,111 @@ mlx_err set_tracer(bool is_tracer, mlx_array arr);
 mlx_err add(mlx_array *res, mlx_array a, mlx_array b);
 mlx_err subtract(mlx_array *res, mlx_array a, mlx_array b);
 mlx_err multiply(mlx_array *res, mlx_array a, mlx_array b);
-mlx_err divide(mlx_array *res, mlx_array a, mlx_array b);
\ No newline at end of file
+mlx_err divide(mlx_array *res, mlx_array a, mlx_array b);
+
+// Ops between an array and a scalar operand placed on `side`. The scalar takes
+// the array's dtype, except that float scalars (`mlx_scalar_float`) promote
+// integer arrays to float32.
+mlx_err add_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                   mlx_operator_side side);
+mlx_err subtract_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side);
+mlx_err multiply_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side);
+mlx_err divide_scalar(mlx_array *res, mlx_array arr, mlx_scalar val,
+                      mlx_operator_side side);
+
+// Variants of the ops above that assign the result to the existing handle
+// `res` instead of allocating a new one. `res` may alias an input.
+mlx_err add_into(mlx_array res, mlx_array lhs, mlx_array rhs);
+mlx_err subtract_into(mlx_array res, mlx_array lhs, mlx_array rhs);
+mlx_err multiply_into(mlx_array res, mlx_array lhs, mlx_array rhs);
+mlx_err divide_into(mlx_array res, mlx_array lhs, mlx_array rhs);
+mlx_err add_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                        mlx_operator_side side);
+mlx_err subtract_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                             mlx_operator_side side);
+mlx_err multiply_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                             mlx_operator_side side);
+mlx_err divide_scalar_into(mlx_array res, mlx_array arr, mlx_scalar val,
+                           mlx_operator_side side);
+
+// Variants of the ops above that take ownership of (and destroy) the selected
+// operand handles once the result is created. With no other references left,
+// MLX can reuse an operand's buffer for the output at eval. Arena handles and
+// inline storage are not destroyed but emptied, dropping their reference all
+// the same; they may then only be released. The scalar variants always
+// consume `arr`.
+mlx_err add_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                    bool consume_lhs, bool consume_rhs);
+mlx_err subtract_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                         bool consume_lhs, bool consume_rhs);
+mlx_err multiply_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                         bool consume_lhs, bool consume_rhs);
+mlx_err divide_consume(mlx_array *res, mlx_array lhs, mlx_array rhs,
+                       bool consume_lhs, bool consume_rhs);
+mlx_err add_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                           mlx_operator_side side);
+mlx_err subtract_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                                mlx_operator_side side);
+mlx_err multiply_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                                mlx_operator_side side);
+mlx_err divide_scalar_consume(mlx_array *res, mlx_array arr, mlx_scalar val,
+                              mlx_operator_side side);
+
+// View ops. Results share the input's buffer wherever MLX can express them as
+// a strided view (always for `slice`, `transpose`, `expand_dims`, `squeeze`,
+// `broadcast_to` and `as_strided`; for `reshape` unless the input's layout
+// requires a copy). `slice` takes `n` (== ndim) start/stop/stride triples.
+// `transpose` with no axes reverses them, `squeeze` with no axes drops every
+// size-1 axis. `as_strided` strides are in elements and `offset` is the
+// element offset into the input's buffer.
+mlx_err slice(mlx_array *res, mlx_array arr, const int *start,
+              const int *stop, const int *strides, size_t n);
+mlx_err reshape(mlx_array *res, mlx_array arr, const int *shape,
+                size_t shape_len);
+mlx_err transpose(mlx_array *res, mlx_array arr, const int *axes,
+                  size_t n_axes);
+mlx_err expand_dims(mlx_array *res, mlx_array arr, const int *axes,
+                    size_t n_axes);
+mlx_err squeeze(mlx_array *res, mlx_array arr, const int *axes,
+                size_t n_axes);
+mlx_err broadcast_to(mlx_array *res, mlx_array arr, const int *shape,
+                     size_t shape_len);
+mlx_err as_strided(mlx_array *res, mlx_array arr, const int *shape,
+                   const int64_t *strides, size_t ndim, size_t offset);
+
+// Joins `n` arrays along an existing `axis` (`concatenate`) or a new one
+// (`stack`) in a single call, e.g. to build a minibatch from samples.
+mlx_err concatenate(mlx_array *res, const mlx_array *arrs, size_t n,
+                    int axis);
+mlx_err stack(mlx_array *res, const mlx_array *arrs, size_t n, int axis);
+// Runs `n` elementwise ops in one call, writing one new handle per op to
+// `res`. Operands may be results of earlier ops in the batch, so whole chains
+// cross the boundary once; with `eval` set the results are also evaluated
+// together before returning.
+mlx_err dispatch_batch(mlx_array *res, const mlx_op_desc *ops, size_t n,
+                       bool eval);
+
+// Matrix products. `matmul` multiplies the last two axes of `a` and `b` and
+// broadcasts any leading (batch) axes against each other; 1-D operands are
+// treated as vectors. `addmm` computes `alpha * (a @ b) + beta * c` in one
+// GEMM, with `c` broadcastable to the result. `linear` computes
+// `x @ w.T + b` for a `[out, in]` weight `w`; `b` may be NULL for no bias.
+mlx_err matmul(mlx_array *res, mlx_array a, mlx_array b);
+mlx_err addmm(mlx_array *res, mlx_array c, mlx_array a, mlx_array b,
+              float alpha, float beta);
+mlx_err linear(mlx_array *res, mlx_array x, mlx_array w, mlx_array b);
+
+// Quantization. `quantize` packs the last axis of `w` (divisible by
+// `group_size`) into `bits`-bit integers, 32 / `bits` per uint32, with a scale
+// and bias per group of `group_size` elements; MLX supports group sizes of 32,
+// 64 and 128 and 2, 4 or 8 bits. `quantized_matmul` computes `x @ w.T` (or
+// `x @ w` unless `transpose`) directly on the packed weights.
+mlx_err quantize(mlx_array *res_w, mlx_array *res_scales,
+                 mlx_array *res_biases, mlx_array w, int group_size, int bits);
+mlx_err dequantize(mlx_array *res, mlx_array w, mlx_array scales,
+                   mlx_array biases, int group_size, int bits);
+mlx_err quantized_matmul(mlx_array *res, mlx_array x, mlx_array w,
+                         mlx_array scales, mlx_array biases, bool transpose,
+                         int group_size, int bits);
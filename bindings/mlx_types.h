@@ -2,9 +2,24 @@
 
 typedef enum {
   mlx_success,
+  // `std::exception` not covered by a more specific code below
   mlx_exception,
+  mlx_invalid_argument,
+  mlx_out_of_range,
+  mlx_out_of_memory,
+  mlx_runtime_error,
+  mlx_unknown_error,
 } mlx_err;
 
+// Details of the most recent failed call on the calling thread. `op` and
+// `message` point into thread-local storage that is overwritten by the next
+// failing call on the same thread.
+typedef struct mlx_error_info {
+  mlx_err code;
+  const char *op;
+  const char *message;
+} mlx_error_info;
+
 typedef enum {
   bool_,
   uint8,
@@ -21,6 +36,33 @@ typedef enum {
   complex64,
 } mlx_dtype;
 
+typedef enum {
+  mlx_lhs,
+  mlx_rhs,
+} mlx_operator_side;
+
+typedef enum {
+  mlx_scalar_float,
+  mlx_scalar_int,
+  mlx_scalar_uint,
+} mlx_scalar_kind;
+
+// Scalar operand of the `*_scalar` ops. Integers are carried in `i` or `u` so
+// 64-bit values survive exactly; floats are carried in `f`.
+typedef struct mlx_scalar {
+  mlx_scalar_kind kind;
+  union {
+    double f;
+    int64_t i;
+    uint64_t u;
+  } val;
+} mlx_scalar;
+
+typedef enum {
+  mlx_row_major,
+  mlx_col_major,
+} mlx_layout;
+
 typedef struct mlx_array_flags {
   bool contiguous;
 
@@ -28,6 +70,105 @@ typedef struct mlx_array_flags {
   bool col_contiguous;
 } mlx_array_flags;
 
+// Array metadata filled by `describe`. `shape` and `strides` point to caller
+// buffers holding `capacity` entries each.
+typedef struct mlx_array_desc {
+  mlx_dtype dtype;
+  size_t ndim;
+  size_t capacity;
+  int *shape;
+  int64_t *strides;
+  mlx_array_flags flags;
+  size_t size;
+  size_t nbytes;
+  size_t itemsize;
+  bool is_evaled;
+} mlx_array_desc;
+
+typedef enum {
+  mlx_graph_dot,
+  mlx_graph_json,
+} mlx_graph_format;
+
+// Node filled by `graph_node`. `primitive` is NULL for leaves; `shape` and
+// `inputs` (indices of the input nodes) stay valid as long as the graph.
+// `live_bytes` estimates the resident bytes once the node is computed.
+typedef struct mlx_graph_node {
+  size_t id;
+  const char *primitive;
+  mlx_dtype dtype;
+  size_t ndim;
+  const int64_t *shape;
+  size_t nbytes;
+  bool is_evaled;
+  size_t n_inputs;
+  const size_t *inputs;
+  size_t live_bytes;
+} mlx_graph_node;
+
+// Memory estimate for evaluating a graph: bytes already evaluated, bytes its
+// pending nodes will allocate, and the simulated peak while evaluating.
+typedef struct mlx_graph_memory {
+  size_t resident_bytes;
+  size_t pending_bytes;
+  size_t peak_bytes;
+} mlx_graph_memory;
+
+// Per-binding totals collected while profiling is enabled. `op` is the name
+// of the exported function; `graph_nodes` counts the unevaluated arrays
+// computed by eval bindings.
+typedef struct mlx_profile_stat {
+  const char *op;
+  size_t calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  size_t bytes_allocated;
+  size_t graph_nodes;
+} mlx_profile_stat;
+
 typedef void *mlx_array;
 typedef void *mlx_array_iterator;
 typedef void *mlx_primitive;
+typedef void *mlx_future;
+typedef void *mlx_arena;
+typedef void *mlx_stream;
+typedef void *mlx_array_map;
+typedef void *mlx_compiled;
+typedef void *mlx_graph;
+
+// Inline storage for one array: room for an `mlx::core::array` (a single
+// shared pointer) and the tag marking it as inline storage, aligned like a
+// pointer. A pointer to constructed storage is itself a valid `mlx_array`.
+typedef struct mlx_array_storage {
+  void *impl[3];
+} mlx_array_storage;
+
+typedef enum {
+  mlx_op_add,
+  mlx_op_subtract,
+  mlx_op_multiply,
+  mlx_op_divide,
+} mlx_binary_op;
+
+// Operand of a `dispatch_batch` op: the array `arr`, the result of an earlier
+// op in the same batch when `result` >= 0, or else (`arr` NULL) the scalar
+// `val`, typed as for the `*_scalar` ops.
+typedef struct mlx_operand {
+  mlx_array arr;
+  int64_t result;
+  mlx_scalar val;
+} mlx_operand;
+
+typedef struct mlx_op_desc {
+  mlx_binary_op op;
+  mlx_operand lhs;
+  mlx_operand rhs;
+} mlx_op_desc;
+
+typedef void (*mlx_deleter)(void *ctx, void *data);
+
+// Function body for `compile_fn`: reads `n_inputs` arrays and writes
+// `n_outputs` new array handles.
+typedef mlx_err (*mlx_closure_fn)(mlx_array *outputs, size_t n_outputs,
+                                  const mlx_array *inputs, size_t n_inputs,
+                                  void *ctx);
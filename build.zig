@@ -106,6 +106,47 @@ pub fn build(b: *std.Build) !void {
     const test_step = b.step("test", "Run library tests");
     test_step.dependOn(&run_main_tests.step);
 
+    // Benchmarks
+    const bench_exe = b.addExecutable(.{
+        .name = "bench",
+        .root_source_file = .{ .path = "bench/bench.zig" },
+        .target = target,
+        .optimize = optimize,
+        .link_libc = true,
+    });
+    bench_exe.addModule("zigMLX", main_module);
+    bench_exe.step.dependOn(&bindings_lib.step);
+    bench_exe.addRPath(.{ .path = "zig-out/lib" });
+    bench_exe.addLibraryPath(.{ .path = "zig-out/lib" });
+    bench_exe.addIncludePath(.{ .path = "bindings" });
+    bench_exe.linkSystemLibrary("mlx_bindings");
+
+    const run_bench = b.addRunArtifact(bench_exe);
+
+    const bench_step = b.step("bench", "Run benchmarks");
+    bench_step.dependOn(&run_bench.step);
+
+    // Multi-threaded stress/scaling harness
+    const stress_exe = b.addExecutable(.{
+        .name = "stress",
+        .root_source_file = .{ .path = "bench/stress.zig" },
+        .target = target,
+        .optimize = optimize,
+        .link_libc = true,
+    });
+    stress_exe.addModule("zigMLX", main_module);
+    stress_exe.step.dependOn(&bindings_lib.step);
+    stress_exe.addRPath(.{ .path = "zig-out/lib" });
+    stress_exe.addLibraryPath(.{ .path = "zig-out/lib" });
+    stress_exe.addIncludePath(.{ .path = "bindings" });
+    stress_exe.linkSystemLibrary("mlx_bindings");
+
+    const run_stress = b.addRunArtifact(stress_exe);
+    if (b.args) |args| run_stress.addArgs(args);
+
+    const stress_step = b.step("stress", "Run multi-threaded stress/scaling benchmark");
+    stress_step.dependOn(&run_stress.step);
+
     const clang_fmt = b.addSystemCommand(&[_][]const u8{ "clang-format", "-i", "bindings/mlx_types.h", "bindings/mlx.cc", "bindings/mlx.h" });
     const zig_fmt = b.addSystemCommand(&[_][]const u8{ "zig", "fmt", "." });
     zig_fmt.step.dependOn(&clang_fmt.step);
@@ -1,8 +1,95 @@
 const std = @import("std");
 const mlx = @import("mlx.zig");
 
+/// Maximum rank supported when passing shapes across the C bindings.
+pub const max_dims = 32;
+
+/// Narrows an `i64` shape (or list of axes) into the `c_int` layout expected
+/// by the bindings.
+pub fn cShape(shape_: []const i64, buf: *[max_dims]c_int) ![]const c_int {
+    if (shape_.len > max_dims) return error.TooManyDimensions;
+    for (shape_, 0..) |v, i| buf[i] = @intCast(v);
+    return buf[0..shape_.len];
+}
+
+/// Handle passed for an optional PRNG key; null selects MLX's global state.
+fn keyHandle(key: ?Array) mlx.mlx_array {
+    return if (key) |k| k.handle else null;
+}
+
+/// Returns the MLX dtype corresponding to the Zig type `T`.
+pub fn dtypeOf(comptime T: type) mlx.mlx_dtype {
+    return switch (T) {
+        bool => mlx.bool_,
+        u8 => mlx.uint8,
+        u16 => mlx.uint16,
+        u32 => mlx.uint32,
+        u64 => mlx.uint64,
+        i8 => mlx.int8,
+        i16 => mlx.int16,
+        i32 => mlx.int32,
+        i64 => mlx.int64,
+        f16 => mlx.float16,
+        f32 => mlx.float32,
+        else => @compileError("dtypeOf: no MLX dtype for " ++ @typeName(T)),
+    };
+}
+
+/// Returns the size in bytes of one element of `data_type`.
+pub fn dtypeSize(data_type: mlx.mlx_dtype) usize {
+    return switch (data_type) {
+        mlx.bool_, mlx.uint8, mlx.int8 => 1,
+        mlx.uint16, mlx.int16, mlx.float16, mlx.bfloat16 => 2,
+        mlx.uint32, mlx.int32, mlx.float32 => 4,
+        mlx.uint64, mlx.int64, mlx.complex64 => 8,
+        else => 0,
+    };
+}
+
+/// Context handed to MLX alongside a slice whose ownership was transferred
+/// via `Array.fromOwnedSlice`; frees the slice once MLX releases it.
+fn OwnedSlice(comptime Slice: type) type {
+    return struct {
+        allocator: std.mem.Allocator,
+        buf: Slice,
+
+        fn release(ctx: ?*anyopaque, _: ?*anyopaque) callconv(.C) void {
+            const self: *@This() = @ptrCast(@alignCast(ctx));
+            const allocator = self.allocator;
+            allocator.free(self.buf);
+            allocator.destroy(self);
+        }
+    };
+}
+
+/// Metadata of an MLX array gathered by `Array.describe`.
+pub const Descriptor = struct {
+    dtype: mlx.mlx_dtype,
+    ndim: usize,
+    flags: mlx.mlx_array_flags,
+    /// Number of elements.
+    size: usize,
+    nbytes: usize,
+    itemsize: usize,
+    is_evaled: bool,
+    shape_buf: [max_dims]c_int,
+    strides_buf: [max_dims]i64,
+
+    pub fn shape(self: *const Descriptor) []const c_int {
+        return self.shape_buf[0..self.ndim];
+    }
+
+    /// Strides in elements; negative for reversed views.
+    pub fn strides(self: *const Descriptor) []const i64 {
+        return self.strides_buf[0..self.ndim];
+    }
+};
+
 /// Convenience wrapper around ptr to MLX's array.
-pub const Array = struct {
+///
+/// `extern` so that a slice of `Array` can be passed to the bindings as an
+/// `mlx_array` pointer.
+pub const Array = extern struct {
     /// Pointer to the underlying MLX array.
     handle: mlx.mlx_array = null,
 
@@ -33,8 +120,10 @@ pub const Array = struct {
 
     /// Initialize an MLX array of the given shape and dtype.
     pub fn initHandle(shape_: []const i64, data_type: mlx.mlx_dtype) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
         var handle: mlx.mlx_array = null;
-        try mlx.MLX_CHECK(mlx.initHandle(&handle, shape_.ptr, @intCast(shape_.len), data_type), @src());
+        try mlx.MLX_CHECK(mlx.initHandle(&handle, c_shape.ptr, c_shape.len, data_type), @src());
         return .{ .handle = handle };
     }
 
@@ -45,21 +134,141 @@ pub const Array = struct {
         return .{ .handle = handle };
     }
 
-    /// Initialize an MLX array from a slice.
+    /// Initialize an MLX array from a slice (copies the data). When
+    /// `data_type` differs from the dtype of `T`, elements are converted while
+    /// being copied, so e.g. `f32` data lands directly in a `bfloat16` array
+    /// without a full-precision intermediate. Zig has no bf16 type, so `u16`
+    /// data with a `bfloat16` target is taken as raw bf16 bits.
     pub fn fromSlice(comptime T: type, d: []const T, shape_: []const i64, data_type: mlx.mlx_dtype) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
         var handle: mlx.mlx_array = null;
-        try mlx.MLX_CHECK(mlx.fromPtr(&handle, d.ptr, shape_.ptr, @intCast(shape_.len), data_type), @src());
+        const src_type = comptime dtypeOf(T);
+        if (src_type == data_type or (T == u16 and data_type == mlx.bfloat16)) {
+            try mlx.MLX_CHECK(mlx.fromPtr(&handle, d.ptr, c_shape.ptr, c_shape.len, data_type), @src());
+        } else {
+            try mlx.MLX_CHECK(mlx.fromPtrConvert(&handle, d.ptr, c_shape.ptr, c_shape.len, src_type, data_type), @src());
+        }
+        return .{ .handle = handle };
+    }
+
+    /// Initialize an MLX array that uses `buf` as its storage without copying.
+    ///
+    /// Ownership of `buf` (which must have been allocated with `allocator`)
+    /// moves to the array; it is freed once MLX drops the last reference to
+    /// the storage, which may happen on MLX's evaluation thread. On error,
+    /// ownership stays with the caller. Returns `error.SizeMismatch` unless
+    /// `buf` holds exactly `shape_` elements of `data_type`.
+    pub fn fromOwnedSlice(allocator: std.mem.Allocator, buf: anytype, shape_: []const i64, data_type: mlx.mlx_dtype) !Array {
+        const Ctx = OwnedSlice(@TypeOf(buf));
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        var n: usize = 1;
+        for (shape_) |d| n *= std.math.cast(usize, d) orelse return error.SizeMismatch;
+        if (std.mem.sliceAsBytes(buf).len != n * dtypeSize(data_type)) return error.SizeMismatch;
+        const ctx = try allocator.create(Ctx);
+        errdefer allocator.destroy(ctx);
+        ctx.* = .{ .allocator = allocator, .buf = buf };
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.fromPtrNoCopy(&handle, @ptrCast(buf.ptr), c_shape.ptr, c_shape.len, data_type, Ctx.release, ctx), @src());
         return .{ .handle = handle };
     }
 
     /// Intialize a random MLX array with normal distribution of the given
     /// shape and dtype.
     pub fn randomNormal(shape_: []const i64, data_type: mlx.mlx_dtype) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.randomNormal(&handle, c_shape.ptr, c_shape.len, data_type), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Creates a PRNG key from `seed`. Samples drawn with a key depend only
+    /// on the key, so each thread can hold its own and generate reproducibly
+    /// without contending on MLX's global random state.
+    pub fn randomKey(seed: u64) !Array {
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.randomKey(&handle, seed), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Splits the key into `n` independent keys, e.g. one per worker thread.
+    ///
+    /// The caller owns the returned keys; release them with `deinitSlice`.
+    pub fn splitKey(self: *const Array, allocator: std.mem.Allocator, n: usize) ![]Array {
+        const res = try allocator.alloc(Array, n);
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.randomSplit(@ptrCast(res.ptr), n, self.handle), @src());
+        return res;
+    }
+
+    /// Samples a normal distribution with the given mean and standard
+    /// deviation. A null `key` uses MLX's global random state.
+    pub fn randomNormalKey(shape_: []const i64, data_type: mlx.mlx_dtype, loc: f32, scale: f32, key: ?Array) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.randomNormalKey(&handle, c_shape.ptr, c_shape.len, data_type, loc, scale, keyHandle(key)), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Samples uniformly from `[low, high)`. A null `key` uses MLX's global
+    /// random state.
+    pub fn randomUniform(low: f64, high: f64, shape_: []const i64, data_type: mlx.mlx_dtype, key: ?Array) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.randomUniform(&handle, low, high, c_shape.ptr, c_shape.len, data_type, keyHandle(key)), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Samples booleans that are true with probability `p`. A null `key` uses
+    /// MLX's global random state.
+    pub fn randomBernoulli(p: f64, shape_: []const i64, key: ?Array) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
         var handle: mlx.mlx_array = null;
-        try mlx.MLX_CHECK(mlx.randomNormal(&handle, shape_.ptr, @intCast(shape_.len), data_type), @src());
+        try mlx.MLX_CHECK(mlx.randomBernoulli(&handle, p, c_shape.ptr, c_shape.len, keyHandle(key)), @src());
         return .{ .handle = handle };
     }
 
+    /// Samples integers uniformly from `[low, high)`. A null `key` uses MLX's
+    /// global random state.
+    pub fn randomRandint(low: i64, high: i64, shape_: []const i64, data_type: mlx.mlx_dtype, key: ?Array) !Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.randomRandint(&handle, low, high, c_shape.ptr, c_shape.len, data_type, keyHandle(key)), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Draws `n` independent standard normal arrays of `shape_` in a single
+    /// generation pass.
+    ///
+    /// The caller owns the returned arrays; release them with `deinitSlice`.
+    pub fn randomNormalBatch(allocator: std.mem.Allocator, n: usize, shape_: []const i64, data_type: mlx.mlx_dtype, key: ?Array) ![]Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        const res = try allocator.alloc(Array, n);
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.randomNormalBatch(@ptrCast(res.ptr), n, c_shape.ptr, c_shape.len, data_type, keyHandle(key)), @src());
+        return res;
+    }
+
+    /// Draws `n` independent arrays of `shape_` sampled uniformly from
+    /// `[low, high)` in a single generation pass.
+    ///
+    /// The caller owns the returned arrays; release them with `deinitSlice`.
+    pub fn randomUniformBatch(allocator: std.mem.Allocator, n: usize, low: f64, high: f64, shape_: []const i64, data_type: mlx.mlx_dtype, key: ?Array) ![]Array {
+        var shape_buf: [max_dims]c_int = undefined;
+        const c_shape = try cShape(shape_, &shape_buf);
+        const res = try allocator.alloc(Array, n);
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.randomUniformBatch(@ptrCast(res.ptr), n, low, high, c_shape.ptr, c_shape.len, data_type, keyHandle(key)), @src());
+        return res;
+    }
+
     /// Frees the underlying memory of the MLX array.
     pub fn deinit(self: *Array) void {
         if (self.handle != null) {
@@ -98,11 +307,9 @@ pub const Array = struct {
 
     /// Returns the shape of the MLX array.
     pub fn shape(self: *const Array, allocator: std.mem.Allocator) ![]i64 {
-        const ndims = try self.ndim();
-        var c_shape: ?*anyopaque = null;
-        try mlx.MLX_CHECK(mlx.shape(&c_shape, self.handle), @src());
-        var res = try allocator.alloc(i64, ndims);
-        for (@as([*c]c_int, @ptrCast(@alignCast(c_shape)))[0..ndims], 0..) |v, i| {
+        const desc = try self.describe();
+        var res = try allocator.alloc(i64, desc.ndim);
+        for (desc.shape(), 0..) |v, i| {
             res[i] = @intCast(v);
         }
         return res;
@@ -118,14 +325,10 @@ pub const Array = struct {
         return @intCast(res);
     }
 
-    /// Returns the strides of the MLX array.
-    pub fn strides(self: *const Array, allocator: std.mem.Allocator) ![]usize {
-        var stride_len: usize = undefined;
-        var c_strides: ?*anyopaque = null;
-        try mlx.MLX_CHECK(mlx.strides(&c_strides, &stride_len, self.handle), @src());
-        const res = try allocator.alloc(usize, stride_len);
-        @memcpy(res, @as([*c]usize, @ptrCast(@alignCast(c_strides)))[0..stride_len]);
-        return res;
+    /// Returns the strides of the MLX array; only meaningful once evaluated.
+    pub fn strides(self: *const Array, allocator: std.mem.Allocator) ![]i64 {
+        const desc = try self.describe();
+        return allocator.dupe(i64, desc.strides());
     }
 
     /// Returns the data type of the MLX array.
@@ -135,11 +338,50 @@ pub const Array = struct {
         return data_type;
     }
 
+    /// Returns the MLX array's dtype, shape, strides, flags and sizes using a
+    /// single binding call. Nothing is evaluated, so `strides` and `flags` are
+    /// only valid when `is_evaled` is set.
+    pub fn describe(self: *const Array) !Descriptor {
+        var res: Descriptor = undefined;
+        var desc: mlx.mlx_array_desc = undefined;
+        desc.capacity = max_dims;
+        desc.shape = &res.shape_buf;
+        desc.strides = &res.strides_buf;
+        try mlx.MLX_CHECK(mlx.describe(&desc, self.handle), @src());
+        res.dtype = desc.dtype;
+        res.ndim = desc.ndim;
+        res.flags = desc.flags;
+        res.size = desc.size;
+        res.nbytes = desc.nbytes;
+        res.itemsize = desc.itemsize;
+        res.is_evaled = desc.is_evaled;
+        return res;
+    }
+
     /// Evaluates the MLX array.
     pub fn eval(self: *const Array, retain_graph: bool) !void {
         return mlx.MLX_CHECK(mlx.eval_array(retain_graph, self.handle), @src());
     }
 
+    /// Evaluates all of the given MLX arrays in a single graph traversal, so
+    /// shared subgraphs are only computed once.
+    pub fn evalMany(arrays: []const Array) !void {
+        return mlx.MLX_CHECK(mlx.eval_many(@ptrCast(arrays.ptr), arrays.len), @src());
+    }
+
+    /// Schedules evaluation of the MLX array and returns without waiting.
+    pub fn evalAsync(self: *const Array) !Future {
+        return evalManyAsync(@as(*const [1]Array, self));
+    }
+
+    /// Schedules evaluation of all of the given MLX arrays and returns
+    /// without waiting.
+    pub fn evalManyAsync(arrays: []const Array) !Future {
+        var handle: mlx.mlx_future = null;
+        try mlx.MLX_CHECK(mlx.async_eval(&handle, @ptrCast(arrays.ptr), arrays.len), @src());
+        return .{ .handle = handle };
+    }
+
     /// Returns the value from a scalar array
     pub fn item(self: *const Array, comptime T: type, retain_graph: bool) !T {
         var res: T = undefined;
@@ -159,6 +401,40 @@ pub const Array = struct {
         return .{ .handle = iter };
     }
 
+    /// Splits the MLX array along axis 0 into views of `chunk_size` rows (the
+    /// last may be shorter) in a single binding call. If `eval_chunks` is set
+    /// the chunks are evaluated together before returning.
+    ///
+    /// The caller owns the returned arrays; release them with `deinitSlice`.
+    pub fn splitChunks(self: *const Array, allocator: std.mem.Allocator, chunk_size: usize, eval_chunks: bool) ![]Array {
+        if (chunk_size == 0) return error.InvalidChunkSize;
+        const rows: usize = @intCast(try self.dim(0));
+        const res = try allocator.alloc(Array, @max(1, std.math.divCeil(usize, rows, chunk_size) catch unreachable));
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.split_chunks(@ptrCast(res.ptr), res.len, self.handle, @intCast(chunk_size), eval_chunks), @src());
+        return res;
+    }
+
+    /// Splits the MLX array along axis 0 before each of the given row
+    /// `indices`, returning `indices.len + 1` views in a single binding call.
+    ///
+    /// The caller owns the returned arrays; release them with `deinitSlice`.
+    pub fn splitAt(self: *const Array, allocator: std.mem.Allocator, indices: []const i64, eval_chunks: bool) ![]Array {
+        const c_indices = try allocator.alloc(c_int, indices.len);
+        defer allocator.free(c_indices);
+        for (indices, c_indices) |v, *c| c.* = @intCast(v);
+        const res = try allocator.alloc(Array, indices.len + 1);
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.split_indices(@ptrCast(res.ptr), self.handle, c_indices.ptr, c_indices.len, eval_chunks), @src());
+        return res;
+    }
+
+    /// Frees every MLX array in `arrays` along with the slice itself.
+    pub fn deinitSlice(allocator: std.mem.Allocator, arrays: []Array) void {
+        for (arrays) |*arr| arr.deinit();
+        allocator.free(arrays);
+    }
+
     /// Returns a unique identifier for the MLX array.
     pub fn id(self: *const Array) !usize {
         var res: usize = undefined;
@@ -180,15 +456,50 @@ pub const Array = struct {
         return res;
     }
 
-    // TODO: pub fn inputs() ![]const Array {}
+    /// Returns the name of the primitive producing the MLX array, or null for
+    /// leaves (including arrays detached by an earlier eval).
+    pub fn primitiveName(self: *const Array) !?[]const u8 {
+        var res: [*c]const u8 = null;
+        try mlx.MLX_CHECK(mlx.primitive_name(&res, self.handle), @src());
+        return if (res != null) std.mem.span(res) else null;
+    }
+
+    /// Returns the number of inputs of the MLX array's primitive.
+    pub fn numInputs(self: *const Array) !usize {
+        var res: usize = undefined;
+        try mlx.MLX_CHECK(mlx.num_inputs(&res, self.handle), @src());
+        return res;
+    }
 
-    // TODO: pub fn editableInputs() ![]Array {}
+    /// Returns new handles to the inputs of the MLX array's primitive.
+    ///
+    /// The caller owns the returned arrays; release them with `deinitSlice`.
+    pub fn inputs(self: *const Array, allocator: std.mem.Allocator) ![]Array {
+        const res = try allocator.alloc(Array, try self.numInputs());
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.inputs(@ptrCast(res.ptr), res.len, self.handle), @src());
+        return res;
+    }
+
+    /// Returns handles to the input slots of the MLX array, so assigning
+    /// through them (e.g. with `ops.addInto`) rewires the graph.
+    ///
+    /// Free the result with `deinitSlice`, and stop assigning through the
+    /// handles once `self` is freed, detached or evaluated.
+    pub fn editableInputs(self: *const Array, allocator: std.mem.Allocator) ![]Array {
+        const res = try allocator.alloc(Array, try self.numInputs());
+        errdefer allocator.free(res);
+        try mlx.MLX_CHECK(mlx.editable_inputs(@ptrCast(res.ptr), res.len, self.handle), @src());
+        return res;
+    }
 
     /// Detaches the MLX array from the graph.
     pub fn detach(self: *const Array) !void {
         return mlx.MLX_CHECK(mlx.detach(self.handle), @src());
     }
 
+    /// Returns the contiguity flags; like `strides`, these only describe the
+    /// real layout once the array is evaluated.
     pub fn flags(self: *const Array) !mlx.mlx_array_flags {
         var res: mlx.mlx_array_flags = undefined;
         try mlx.MLX_CHECK(mlx.flags(&res, self.handle), @src());
@@ -203,21 +514,36 @@ pub const Array = struct {
     }
 
     /// Returns slice (non-allocated) to the underlying data of the MLX array.
+    ///
+    /// The slice is the raw buffer of `dataSize()` elements: for transposed or
+    /// broadcast views its layout follows `strides`, not `shape`. Use `copyTo`
+    /// for a dense copy.
     pub fn data(self: *const Array, comptime T: type) ![]const T {
         var ptr: ?*anyopaque = null;
         try mlx.MLX_CHECK(mlx.data(&ptr, self.handle), @src());
-        return @as([*c]T, @ptrCast(@alignCast(ptr)))[0..try self.size()];
+        return @as([*c]T, @ptrCast(@alignCast(ptr)))[0..try self.dataSize()];
     }
 
-    /// Returns slice (allocated) to the underlying data of the MLX array.
+    /// Returns a dense, row-major copy (allocated) of the MLX array's data,
+    /// converted to `T`.
     pub fn allocData(self: *const Array, comptime T: type, allocator: std.mem.Allocator) ![]T {
-        var ptr: ?*anyopaque = null;
-        try mlx.MLX_CHECK(mlx.data(&ptr, self.handle), @src());
         const res = try allocator.alloc(T, try self.size());
-        @memcpy(res, @as([*c]T, @ptrCast(@alignCast(ptr)))[0..try self.size()]);
+        errdefer allocator.free(res);
+        try self.copyTo(T, res, mlx.mlx_row_major);
         return res;
     }
 
+    /// Evaluates the MLX array and writes it into `dst` as a dense array in
+    /// the given layout, converting elements to `T`. Strided and broadcast
+    /// views are read in place, without an intermediate contiguous copy.
+    /// Mirroring `fromSlice`, a `bfloat16` array copied to `u16` yields the
+    /// raw bf16 bits.
+    pub fn copyTo(self: *const Array, comptime T: type, dst: []T, layout: mlx.mlx_layout) !void {
+        if (dst.len != try self.size()) return error.SizeMismatch;
+        const dst_type = if (T == u16 and try self.dtype() == mlx.bfloat16) mlx.bfloat16 else dtypeOf(T);
+        return mlx.MLX_CHECK(mlx.copy_to(self.handle, dst.ptr, dst_type, layout), @src());
+    }
+
     /// Check if the MLX array has been evaluated.
     pub fn isEvaled(self: *const Array) !bool {
         var res: bool = undefined;
@@ -231,6 +557,51 @@ pub const Array = struct {
     }
 };
 
+/// An MLX array stored inline instead of behind a heap-allocated handle, so
+/// arrays can live on the stack or in contiguous slices (e.g. one per model
+/// parameter) without a handle allocation or the extra pointer load.
+///
+/// `array()` returns a borrowed `Array` usable with every API; calling `deinit`
+/// on it leaves the storage intact, since the bindings recognise inline
+/// storage, while a consuming op empties it. The `*Into` ops can write results
+/// straight into the storage. An `InlineArray` may be moved (copied bitwise) but each
+/// constructed value must be released exactly once with `deinit`.
+pub const InlineArray = extern struct {
+    storage: mlx.mlx_array_storage,
+
+    /// Returns inline storage sharing `arr`'s data; `arr` stays owned by the
+    /// caller.
+    pub fn initCopy(arr: Array) !InlineArray {
+        var res: InlineArray = undefined;
+        try mlx.MLX_CHECK(mlx.array_storage_copy(&res.storage, arr.handle), @src());
+        return res;
+    }
+
+    /// Moves `arr` into inline storage and frees its heap handle.
+    pub fn initTake(arr: *Array) !InlineArray {
+        var res: InlineArray = undefined;
+        try mlx.MLX_CHECK(mlx.array_storage_take(&res.storage, arr.handle), @src());
+        arr.handle = null;
+        return res;
+    }
+
+    pub fn deinit(self: *InlineArray) void {
+        mlx.array_storage_destroy(&self.storage);
+    }
+
+    /// Returns a borrowed handle to the stored array, valid while `self` is
+    /// neither moved nor deinit'd.
+    pub fn array(self: *InlineArray) Array {
+        return Array.init(@ptrCast(&self.storage));
+    }
+
+    /// Frees every array in `arrays` along with the slice itself.
+    pub fn deinitSlice(allocator: std.mem.Allocator, arrays: []InlineArray) void {
+        for (arrays) |*arr| arr.deinit();
+        allocator.free(arrays);
+    }
+};
+
 pub const ArrayIterator = struct {
     handle: mlx.mlx_array_iterator = null,
 
@@ -251,13 +622,83 @@ pub const ArrayIterator = struct {
 
     pub fn eql(self: *const ArrayIterator, other: ArrayIterator) !bool {
         var res: bool = undefined;
-        try mlx.MLX_CHECK(mlx.eql(&res, self.handle, other.handle), @src());
+        try mlx.MLX_CHECK(mlx.arrayIterEql(&res, self.handle, other.handle), @src());
         return res;
     }
 
     pub fn neq(self: *const ArrayIterator, other: ArrayIterator) !bool {
         var res: bool = undefined;
-        try mlx.MLX_CHECK(mlx.neql(&res, self.handle, other.handle), @src());
+        try mlx.MLX_CHECK(mlx.arrayIterNeq(&res, self.handle, other.handle), @src());
+        return res;
+    }
+};
+
+/// Places every array handle created on the current thread in an MLX arena
+/// while the scope is active, so the intermediates of e.g. a forward pass are
+/// released in bulk instead of one `deinit` each.
+///
+/// Calling `deinit` on an arena-backed `Array` is a no-op, even after the
+/// scope is closed; such handles are invalidated by `reset` and `deinit`. Use `persist`
+/// for results that must outlive the scope. Consuming ops empty arena-backed
+/// operands in place, so their buffers can still be donated.
+pub const ArenaScope = struct {
+    handle: mlx.mlx_arena = null,
+
+    /// Creates an arena with `slab_size` handles per slab and activates it on
+    /// the current thread.
+    pub fn init(slab_size: usize) !ArenaScope {
+        var handle: mlx.mlx_arena = null;
+        try mlx.MLX_CHECK(mlx.mlx_arena_create(&handle, slab_size), @src());
+        errdefer mlx.mlx_arena_destroy(handle);
+        try mlx.MLX_CHECK(mlx.mlx_arena_push(handle), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Deactivates the arena and releases every handle placed in it. If the
+    /// arena cannot be popped (e.g. nested scopes closed out of order), it is
+    /// left alive rather than destroyed while still active.
+    pub fn deinit(self: *ArenaScope) void {
+        if (self.handle != null) {
+            mlx.MLX_CHECK(mlx.mlx_arena_pop(self.handle), @src()) catch return;
+            mlx.mlx_arena_destroy(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Releases every handle placed in the arena, keeping its slabs for reuse.
+    pub fn reset(self: *const ArenaScope) !void {
+        return mlx.MLX_CHECK(mlx.mlx_arena_reset(self.handle), @src());
+    }
+
+    /// Returns a heap-backed handle to `arr` that outlives the scope.
+    pub fn persist(_: *const ArenaScope, arr: Array) !Array {
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.cloneHandle(&handle, arr.handle), @src());
+        return .{ .handle = handle };
+    }
+};
+
+/// Completion handle for arrays scheduled with `Array.evalAsync` or
+/// `Array.evalManyAsync`.
+pub const Future = struct {
+    handle: mlx.mlx_future = null,
+
+    pub fn deinit(self: *Future) void {
+        if (self.handle != null) {
+            mlx.destroyFuture(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Blocks until all of the scheduled arrays have been evaluated.
+    pub fn wait(self: *const Future) !void {
+        return mlx.MLX_CHECK(mlx.future_wait(self.handle), @src());
+    }
+
+    /// Check if all of the scheduled arrays have been evaluated.
+    pub fn isReady(self: *const Future) !bool {
+        var res: bool = undefined;
+        try mlx.MLX_CHECK(mlx.future_is_ready(&res, self.handle), @src());
         return res;
     }
 };
@@ -282,3 +723,282 @@ test "Array -> Flags" {
     try std.testing.expect(flags.row_contiguous);
     try std.testing.expect(flags.col_contiguous);
 }
+
+test "Array -> fromOwnedSlice" {
+    const allocator = std.testing.allocator;
+    const buf = try allocator.alloc(f32, 4);
+    @memcpy(buf, &[_]f32{ 1, 2, 3, 4 });
+    var arr = try Array.fromOwnedSlice(allocator, buf, &.{4}, mlx.float32);
+    const arr_data = try arr.data(f32);
+    try std.testing.expect(arr_data.ptr == buf.ptr);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3, 4 }, arr_data);
+    // dropping the last reference hands `buf` back to `allocator`
+    arr.deinit();
+}
+
+test "Array -> fromOwnedSlice rejects mismatched buffers" {
+    const allocator = std.testing.allocator;
+    const buf = try allocator.alloc(f32, 3);
+    // on error `buf` is still ours to free
+    defer allocator.free(buf);
+    try std.testing.expectError(error.SizeMismatch, Array.fromOwnedSlice(allocator, buf, &.{4}, mlx.float32));
+    try std.testing.expectError(error.SizeMismatch, Array.fromOwnedSlice(allocator, buf, &.{3}, mlx.float16));
+
+    // a failing binding leaves the deleter uncalled
+    const Flag = struct {
+        fn release(ctx: ?*anyopaque, _: ?*anyopaque) callconv(.C) void {
+            const called: *bool = @ptrCast(@alignCast(ctx));
+            called.* = true;
+        }
+    };
+    var called = false;
+    var handle: mlx.mlx_array = null;
+    const shape_ = [_]c_int{3};
+    try std.testing.expectError(error.MLXInvalidArgument, mlx.MLX_CHECK(mlx.fromPtrNoCopy(&handle, buf.ptr, &shape_, shape_.len, mlx.complex64, Flag.release, &called), @src()));
+    try std.testing.expect(!called);
+    try std.testing.expect(handle == null);
+}
+
+test "Array -> evalMany/evalManyAsync" {
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    var b = try mlx.ops.add(Array, a, f32, 1);
+    defer b.deinit();
+    var c = try mlx.ops.multiply(Array, b, f32, 2);
+    defer c.deinit();
+    try Array.evalMany(&.{ b, c });
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 4 }, try b.data(f32));
+    try std.testing.expectEqualSlices(f32, &.{ 4, 6, 8 }, try c.data(f32));
+
+    var d = try mlx.ops.subtract(Array, c, Array, b);
+    defer d.deinit();
+    var fut = try d.evalAsync();
+    defer fut.deinit();
+    try fut.wait();
+    try std.testing.expect(try fut.isReady());
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 4 }, try d.data(f32));
+}
+
+test "Array -> ArenaScope" {
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    var out = blk: {
+        var scope = try ArenaScope.init(16);
+        defer scope.deinit();
+        var b = try mlx.ops.add(Array, a, f32, 1);
+        defer b.deinit(); // no-op for arena-backed handles
+        const c = try mlx.ops.multiply(Array, b, Array, b);
+        break :blk try scope.persist(c);
+    };
+    defer out.deinit();
+    try out.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 4, 9, 16 }, try out.data(f32));
+
+    // arena handles stay arena-owned once their arena is popped
+    var arena: mlx.mlx_arena = null;
+    try mlx.MLX_CHECK(mlx.mlx_arena_create(&arena, 4), @src());
+    defer mlx.mlx_arena_destroy(arena);
+    try mlx.MLX_CHECK(mlx.mlx_arena_push(arena), @src());
+    var d = mlx.ops.add(Array, a, f32, 1) catch |err| {
+        mlx.MLX_CHECK(mlx.mlx_arena_pop(arena), @src()) catch {};
+        return err;
+    };
+    try mlx.MLX_CHECK(mlx.mlx_arena_pop(arena), @src());
+    d.deinit();
+}
+
+test "Array -> describe" {
+    var arr = try Array.fromSlice(f32, &.{ 1, 2, 3, 4, 5, 6 }, &.{ 2, 3 }, mlx.float32);
+    defer arr.deinit();
+    const desc = try arr.describe();
+    try std.testing.expect(desc.dtype == mlx.float32);
+    try std.testing.expectEqual(@as(usize, 2), desc.ndim);
+    try std.testing.expectEqualSlices(c_int, &.{ 2, 3 }, desc.shape());
+    try std.testing.expectEqualSlices(i64, &.{ 3, 1 }, desc.strides());
+    try std.testing.expectEqual(@as(usize, 6), desc.size);
+    try std.testing.expectEqual(@as(usize, 24), desc.nbytes);
+    try std.testing.expect(desc.is_evaled);
+    try std.testing.expect(desc.flags.row_contiguous);
+
+    const shape = try arr.shape(std.testing.allocator);
+    defer std.testing.allocator.free(shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 3 }, shape);
+}
+
+test "Array -> copyTo" {
+    var arr = try Array.fromSlice(i32, &.{ 1, 2, 3, 4, 5, 6 }, &.{ 2, 3 }, mlx.int32);
+    defer arr.deinit();
+    var row_major: [6]f32 = undefined;
+    try arr.copyTo(f32, &row_major, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3, 4, 5, 6 }, &row_major);
+    var col_major: [6]i64 = undefined;
+    try arr.copyTo(i64, &col_major, mlx.mlx_col_major);
+    try std.testing.expectEqualSlices(i64, &.{ 1, 4, 2, 5, 3, 6 }, &col_major);
+}
+
+test "Array -> splitChunks/splitAt" {
+    const allocator = std.testing.allocator;
+    var arr = try Array.fromSlice(f32, &.{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 }, &.{ 5, 2 }, mlx.float32);
+    defer arr.deinit();
+
+    const chunks = try arr.splitChunks(allocator, 2, true);
+    defer Array.deinitSlice(allocator, chunks);
+    try std.testing.expectEqual(@as(usize, 3), chunks.len);
+    const last = try chunks[2].allocData(f32, allocator);
+    defer allocator.free(last);
+    try std.testing.expectEqualSlices(f32, &.{ 9, 10 }, last);
+
+    const parts = try arr.splitAt(allocator, &.{ 1, 4 }, false);
+    defer Array.deinitSlice(allocator, parts);
+    try std.testing.expectEqual(@as(usize, 3), parts.len);
+    try std.testing.expectEqual(@as(i64, 3), try parts[1].dim(0));
+}
+
+test "Array -> inputs" {
+    const allocator = std.testing.allocator;
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    var b = try Array.fromSlice(f32, &.{ 1, 1, 1 }, &.{3}, mlx.float32);
+    defer b.deinit();
+    var c = try mlx.ops.add(Array, a, Array, b);
+    defer c.deinit();
+    try std.testing.expectEqualStrings("Add", (try c.primitiveName()).?);
+    try std.testing.expect(try a.primitiveName() == null);
+
+    const ins = try c.inputs(allocator);
+    defer Array.deinitSlice(allocator, ins);
+    try std.testing.expectEqual(@as(usize, 2), ins.len);
+    try std.testing.expectEqual(try a.id(), try ins[0].id());
+
+    const slots = try c.editableInputs(allocator);
+    defer Array.deinitSlice(allocator, slots);
+    try mlx.ops.multiplyInto(&slots[1], Array, b, f32, 2);
+    try c.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 3, 4, 5 }, try c.data(f32));
+}
+
+test "Array -> eval retains the graph" {
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    var b = try mlx.ops.add(Array, a, f32, 1);
+    defer b.deinit();
+    var c = try mlx.ops.multiply(Array, b, f32, 2);
+    defer c.deinit();
+    try c.eval(true);
+    try std.testing.expectEqualSlices(f32, &.{ 4, 6, 8 }, try c.data(f32));
+    try std.testing.expectEqual(@as(usize, 2), try c.numInputs());
+    try std.testing.expectEqual(@as(usize, 2), try b.numInputs());
+}
+
+test "Array -> random keys" {
+    const allocator = std.testing.allocator;
+    var key = try Array.randomKey(42);
+    defer key.deinit();
+    var a = try Array.randomUniform(0, 1, &.{8}, mlx.float32, key);
+    defer a.deinit();
+    var b = try Array.randomUniform(0, 1, &.{8}, mlx.float32, key);
+    defer b.deinit();
+    try a.eval(false);
+    try b.eval(false);
+    try std.testing.expectEqualSlices(f32, try a.data(f32), try b.data(f32));
+
+    const keys = try key.splitKey(allocator, 2);
+    defer Array.deinitSlice(allocator, keys);
+    var c = try Array.randomRandint(0, 1 << 30, &.{8}, mlx.int32, keys[0]);
+    defer c.deinit();
+    var d = try Array.randomRandint(0, 1 << 30, &.{8}, mlx.int32, keys[1]);
+    defer d.deinit();
+    try c.eval(false);
+    try d.eval(false);
+    try std.testing.expect(!std.mem.eql(i32, try c.data(i32), try d.data(i32)));
+
+    const batch = try Array.randomNormalBatch(allocator, 3, &.{ 2, 4 }, mlx.float32, key);
+    defer Array.deinitSlice(allocator, batch);
+    try std.testing.expectEqual(@as(usize, 3), batch.len);
+    const shape = try batch[2].shape(allocator);
+    defer allocator.free(shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 4 }, shape);
+}
+
+test "Array -> concurrent eval of a shared subgraph" {
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3, 4 }, &.{4}, mlx.float32);
+    defer x.deinit();
+    var shared = try mlx.ops.multiply(Array, x, f32, 2);
+    defer shared.deinit();
+
+    const Worker = struct {
+        fn run(input: Array, offset: f32, ok: *bool) void {
+            ok.* = check(input, offset) catch false;
+        }
+
+        fn check(input: Array, offset: f32) !bool {
+            var y = try mlx.ops.add(Array, input, f32, offset);
+            defer y.deinit();
+            try y.eval(false);
+            return (try y.data(f32))[3] == 8 + offset;
+        }
+    };
+    var threads: [4]std.Thread = undefined;
+    var ok = [_]bool{false} ** 4;
+    for (&threads, &ok, 0..) |*t, *res, i| {
+        t.* = try std.Thread.spawn(.{}, Worker.run, .{ shared, @as(f32, @floatFromInt(i)), res });
+    }
+    for (threads) |t| t.join();
+    try std.testing.expectEqualSlices(bool, &.{ true, true, true, true }, &ok);
+}
+
+test "Array -> fromSlice converts on ingest" {
+    var a = try Array.fromSlice(f32, &.{ 1, 2.5, -3 }, &.{3}, mlx.bfloat16);
+    defer a.deinit();
+    try std.testing.expect(try a.dtype() == mlx.bfloat16);
+    var out: [3]f32 = undefined;
+    try a.copyTo(f32, &out, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2.5, -3 }, &out);
+
+    var b = try Array.fromSlice(i32, &.{ 1, 2, 3 }, &.{3}, mlx.float16);
+    defer b.deinit();
+    try std.testing.expect(try b.dtype() == mlx.float16);
+    try b.eval(false);
+    try std.testing.expectEqualSlices(f16, &.{ 1, 2, 3 }, try b.data(f16));
+
+    // u16 is raw bf16 bits both ways
+    const bits = [_]u16{ 0x3f80, 0x4020, 0xc040 };
+    var c = try Array.fromSlice(u16, &bits, &.{3}, mlx.bfloat16);
+    defer c.deinit();
+    const c_bits = try c.allocData(u16, std.testing.allocator);
+    defer std.testing.allocator.free(c_bits);
+    try std.testing.expectEqualSlices(u16, &bits, c_bits);
+}
+
+test "Array -> InlineArray" {
+    const allocator = std.testing.allocator;
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer x.deinit();
+
+    const params = try allocator.alloc(InlineArray, 4);
+    var n_init: usize = 0;
+    defer {
+        for (params[0..n_init]) |*p| p.deinit();
+        allocator.free(params);
+    }
+    for (params) |*p| {
+        p.* = try InlineArray.initCopy(x);
+        n_init += 1;
+    }
+    var slot = params[1].array();
+    try mlx.ops.addInto(&slot, Array, params[0].array(), f32, 1);
+    slot.deinit(); // no-op for inline storage
+
+    var y = try mlx.ops.multiply(Array, params[1].array(), f32, 2);
+    defer y.deinit();
+    const taken = try InlineArray.initTake(&y);
+    try std.testing.expect(y.handle == null);
+    params[2].deinit();
+    params[2] = taken;
+
+    var out: [3]f32 = undefined;
+    try params[2].array().copyTo(f32, &out, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 4, 6, 8 }, &out);
+    try params[0].array().copyTo(f32, &out, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3 }, &out);
+}
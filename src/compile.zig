@@ -0,0 +1,111 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+/// Functions that can be compiled: read `inputs` and write a new array to
+/// every slot of `outputs`. The compiled wrapper takes ownership of the
+/// outputs, so they must not be deinit'd.
+pub const Fn = fn (inputs: []const Array, outputs: []Array) anyerror!void;
+
+/// A function compiled with MLX's `compile`: its elementwise chains are fused
+/// into single kernels instead of materializing every intermediate.
+///
+/// MLX traces the function once per input shape/dtype signature (once overall
+/// when `shapeless`) and caches the result for the lifetime of the handle, so
+/// keep the `Compiled` around rather than re-creating it per call.
+pub const Compiled = struct {
+    handle: mlx.mlx_compiled = null,
+    n_outputs: usize,
+
+    pub fn init(comptime f: Fn, n_outputs: usize, shapeless: bool) !Compiled {
+        const Trampoline = struct {
+            fn call(outputs: [*c]mlx.mlx_array, n_out: usize, inputs: [*c]const mlx.mlx_array, n_in: usize, _: ?*anyopaque) callconv(.C) mlx.mlx_err {
+                const in_arrays: [*]const Array = @ptrCast(inputs);
+                const out_arrays: [*]Array = @ptrCast(outputs);
+                f(in_arrays[0..n_in], out_arrays[0..n_out]) catch return mlx.mlx_exception;
+                return mlx.mlx_success;
+            }
+        };
+        var handle: mlx.mlx_compiled = null;
+        try mlx.MLX_CHECK(mlx.compile_fn(&handle, Trampoline.call, null, n_outputs, shapeless), @src());
+        return .{ .handle = handle, .n_outputs = n_outputs };
+    }
+
+    /// Frees the compiled function along with its cached graphs.
+    pub fn deinit(self: *Compiled) void {
+        if (self.handle != null) {
+            mlx.destroyCompiled(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Calls the compiled function, writing `n_outputs` new arrays (owned by
+    /// the caller) to `outputs`.
+    pub fn call(self: *const Compiled, inputs: []const Array, outputs: []Array) !void {
+        if (outputs.len != self.n_outputs) return error.SizeMismatch;
+        return mlx.MLX_CHECK(mlx.compiled_call(@ptrCast(outputs.ptr), outputs.len, self.handle, @ptrCast(inputs.ptr), inputs.len), @src());
+    }
+};
+
+fn scaleShift(inputs: []const Array, outputs: []Array) !void {
+    var scaled = try mlx.ops.multiply(Array, inputs[0], f32, 2);
+    defer scaled.deinit();
+    outputs[0] = try mlx.ops.add(Array, scaled, Array, inputs[1]);
+}
+
+test "Compile -> Compiled.call" {
+    var compiled = try Compiled.init(scaleShift, 1, false);
+    defer compiled.deinit();
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer x.deinit();
+    var y = try Array.fromSlice(f32, &.{ 1, 1, 1 }, &.{3}, mlx.float32);
+    defer y.deinit();
+
+    // second call reuses the cached graph for this shape/dtype
+    for (0..2) |_| {
+        var out: [1]Array = undefined;
+        try compiled.call(&.{ x, y }, &out);
+        defer out[0].deinit();
+        try out[0].eval(false);
+        try std.testing.expectEqualSlices(f32, &.{ 3, 5, 7 }, try out[0].data(f32));
+    }
+}
+
+fn addInputs(inputs: []const Array, outputs: []Array) !void {
+    outputs[0] = try mlx.ops.add(Array, inputs[0], Array, inputs[1]);
+}
+
+test "Compile -> errors keep the failing op" {
+    var compiled = try Compiled.init(addInputs, 1, false);
+    defer compiled.deinit();
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer x.deinit();
+    var y = try Array.fromSlice(f32, &.{ 1, 1 }, &.{2}, mlx.float32);
+    defer y.deinit();
+
+    var out: [1]Array = undefined;
+    try std.testing.expectError(error.MLXInvalidArgument, compiled.call(&.{ x, y }, &out));
+    try std.testing.expectEqualStrings("add", mlx.lastError().op);
+}
+
+fn passThrough(inputs: []const Array, outputs: []Array) !void {
+    outputs[0] = try mlx.ops.multiply(Array, inputs[0], f32, 2);
+    outputs[1] = inputs[1];
+}
+
+test "Compile -> inputs returned as outputs" {
+    var compiled = try Compiled.init(passThrough, 2, false);
+    defer compiled.deinit();
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer x.deinit();
+    var y = try Array.fromSlice(f32, &.{ 4, 5, 6 }, &.{3}, mlx.float32);
+    defer y.deinit();
+
+    var out: [2]Array = undefined;
+    try compiled.call(&.{ x, y }, &out);
+    defer for (&out) |*o| o.deinit();
+    try Array.evalMany(&out);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 4, 6 }, try out[0].data(f32));
+    try std.testing.expectEqualSlices(f32, &.{ 4, 5, 6 }, try out[1].data(f32));
+}
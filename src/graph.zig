@@ -0,0 +1,140 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+pub const Format = enum {
+    dot,
+    json,
+
+    fn cFormat(self: Format) mlx.mlx_graph_format {
+        return switch (self) {
+            .dot => mlx.mlx_graph_dot,
+            .json => mlx.mlx_graph_json,
+        };
+    }
+};
+
+/// Snapshot of every array reachable from a set of outputs, listed inputs
+/// first, taken without evaluating anything. Use it to find where a lazy graph
+/// will blow up memory before calling `eval`, and where to insert evaluation
+/// checkpoints.
+pub const Graph = struct {
+    handle: mlx.mlx_graph = null,
+
+    pub const Node = struct {
+        id: usize,
+        /// Null for leaves (including arrays detached by an earlier eval).
+        primitive: ?[]const u8,
+        dtype: mlx.mlx_dtype,
+        /// Valid for as long as the graph.
+        shape: []const i64,
+        nbytes: usize,
+        is_evaled: bool,
+        /// Indices of the input nodes; valid for as long as the graph.
+        inputs: []const usize,
+        /// Estimated resident bytes once this node is computed.
+        live_bytes: usize,
+    };
+
+    pub const Memory = struct {
+        /// Bytes held by nodes that are already evaluated.
+        resident_bytes: usize,
+        /// Bytes the pending nodes will allocate when evaluated.
+        pending_bytes: usize,
+        /// Estimated peak resident bytes while evaluating the graph, freeing
+        /// each intermediate after its last use.
+        peak_bytes: usize,
+    };
+
+    pub fn init(outputs: []const Array) !Graph {
+        var handle: mlx.mlx_graph = null;
+        try mlx.MLX_CHECK(mlx.graph_build(&handle, @ptrCast(outputs.ptr), outputs.len), @src());
+        return .{ .handle = handle };
+    }
+
+    pub fn deinit(self: *Graph) void {
+        if (self.handle != null) {
+            mlx.destroyGraph(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Returns the number of nodes in the graph.
+    pub fn count(self: *const Graph) !usize {
+        var res: usize = undefined;
+        try mlx.MLX_CHECK(mlx.graph_size(&res, self.handle), @src());
+        return res;
+    }
+
+    /// Returns the `idx`-th node; every input of a node precedes it.
+    pub fn node(self: *const Graph, idx: usize) !Node {
+        var res: mlx.mlx_graph_node = undefined;
+        try mlx.MLX_CHECK(mlx.graph_node(&res, self.handle, idx), @src());
+        return .{
+            .id = res.id,
+            .primitive = if (res.primitive != null) std.mem.span(res.primitive) else null,
+            .dtype = res.dtype,
+            .shape = if (res.ndim > 0) res.shape[0..res.ndim] else &.{},
+            .nbytes = res.nbytes,
+            .is_evaled = res.is_evaled,
+            .inputs = if (res.n_inputs > 0) res.inputs[0..res.n_inputs] else &.{},
+            .live_bytes = res.live_bytes,
+        };
+    }
+
+    pub fn memory(self: *const Graph) !Memory {
+        var res: mlx.mlx_graph_memory = undefined;
+        try mlx.MLX_CHECK(mlx.graph_memory(&res, self.handle), @src());
+        return .{ .resident_bytes = res.resident_bytes, .pending_bytes = res.pending_bytes, .peak_bytes = res.peak_bytes };
+    }
+
+    /// Writes the graph as Graphviz DOT (evaluated nodes filled) or JSON.
+    pub fn save(self: *const Graph, path: [:0]const u8, format: Format) !void {
+        return mlx.MLX_CHECK(mlx.graph_export(self.handle, path.ptr, format.cFormat()), @src());
+    }
+};
+
+test "Graph -> memory estimate" {
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3, 4 }, &.{4}, mlx.float32);
+    defer a.deinit();
+    try a.eval(false);
+    var b = try mlx.ops.multiply(Array, a, f32, 2);
+    defer b.deinit();
+    var c = try mlx.ops.add(Array, b, Array, a);
+    defer c.deinit();
+
+    var graph = try Graph.init(&.{c});
+    defer graph.deinit();
+    const n = try graph.count();
+    const last = try graph.node(n - 1);
+    try std.testing.expectEqual(try c.id(), last.id);
+    try std.testing.expectEqualStrings("Add", last.primitive.?);
+    try std.testing.expectEqualSlices(i64, &.{4}, last.shape);
+    try std.testing.expectEqual(@as(usize, 2), last.inputs.len);
+    try std.testing.expect(!last.is_evaled);
+
+    const mem = try graph.memory();
+    try std.testing.expect(mem.resident_bytes >= 16);
+    try std.testing.expect(mem.pending_bytes >= 32);
+    try std.testing.expect(mem.peak_bytes >= mem.resident_bytes + 32);
+}
+
+test "Graph -> save" {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const path = try std.fmt.allocPrintZ(allocator, "zig-cache/tmp/{s}/graph.dot", .{tmp.sub_path});
+    defer allocator.free(path);
+
+    var a = try Array.fromSlice(f32, &.{ 1, 2 }, &.{2}, mlx.float32);
+    defer a.deinit();
+    var b = try mlx.ops.add(Array, a, f32, 1);
+    defer b.deinit();
+    var graph = try Graph.init(&.{b});
+    defer graph.deinit();
+    try graph.save(path, .dot);
+    const dot = try tmp.dir.readFileAlloc(allocator, "graph.dot", 1 << 16);
+    defer allocator.free(dot);
+    try std.testing.expect(std.mem.startsWith(u8, dot, "digraph mlx {"));
+}
@@ -0,0 +1,123 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+/// Name -> array map returned by `loadSafetensors`, sorted by name.
+pub const ArrayMap = struct {
+    handle: mlx.mlx_array_map = null,
+
+    pub const Entry = struct {
+        /// Valid for as long as the map.
+        name: []const u8,
+        array: Array,
+    };
+
+    /// Frees the map; arrays previously returned from it stay valid.
+    pub fn deinit(self: *ArrayMap) void {
+        if (self.handle != null) {
+            mlx.destroyArrayMap(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Returns the number of arrays in the map.
+    pub fn count(self: *const ArrayMap) !usize {
+        var res: usize = undefined;
+        try mlx.MLX_CHECK(mlx.array_map_size(&res, self.handle), @src());
+        return res;
+    }
+
+    /// Returns a new handle to the array called `name`, or null if the map has
+    /// no such array.
+    pub fn get(self: *const ArrayMap, name: [:0]const u8) !?Array {
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.array_map_get(&handle, self.handle, name.ptr), @src());
+        return if (handle != null) Array.init(handle) else null;
+    }
+
+    /// Returns the `idx`-th entry (by name order); the caller owns `array`.
+    pub fn entry(self: *const ArrayMap, idx: usize) !Entry {
+        var name: [*c]const u8 = null;
+        var handle: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.array_map_entry(&name, &handle, self.handle, idx), @src());
+        return .{ .name = std.mem.span(name), .array = Array.init(handle) };
+    }
+};
+
+/// Loads every tensor of a `.safetensors` file. The file is memory-mapped and
+/// tensors point into the mapping, so data is only read from disk when an
+/// array is first used.
+pub fn loadSafetensors(path: [:0]const u8) !ArrayMap {
+    var handle: mlx.mlx_array_map = null;
+    try mlx.MLX_CHECK(mlx.load_safetensors(&handle, path.ptr), @src());
+    return .{ .handle = handle };
+}
+
+/// Loads a `.npy` file, memory-mapped like `loadSafetensors`.
+pub fn loadNpy(path: [:0]const u8) !Array {
+    var handle: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.load_npy(&handle, path.ptr), @src());
+    return Array.init(handle);
+}
+
+/// Saves `arrays` under the corresponding `names` to a `.safetensors` file,
+/// evaluating and writing one array at a time.
+pub fn saveSafetensors(path: [:0]const u8, names: []const [*:0]const u8, arrays: []const Array) !void {
+    if (names.len != arrays.len) return error.SizeMismatch;
+    return mlx.MLX_CHECK(mlx.save_safetensors(path.ptr, @ptrCast(names.ptr), @ptrCast(arrays.ptr), arrays.len), @src());
+}
+
+/// Saves the array to a `.npy` file.
+pub fn saveNpy(path: [:0]const u8, arr: Array) !void {
+    return mlx.MLX_CHECK(mlx.save_npy(path.ptr, arr.handle), @src());
+}
+
+test "IO -> safetensors round trip" {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const path = try std.fmt.allocPrintZ(allocator, "zig-cache/tmp/{s}/weights.safetensors", .{tmp.sub_path});
+    defer allocator.free(path);
+
+    var w = try Array.fromSlice(f32, &.{ 1, 2, 3, 4, 5, 6 }, &.{ 2, 3 }, mlx.float32);
+    defer w.deinit();
+    var b = try Array.fromSlice(i32, &.{ 7, 8 }, &.{2}, mlx.int32);
+    defer b.deinit();
+    try saveSafetensors(path, &.{ "w", "b" }, &.{ w, b });
+
+    var map = try loadSafetensors(path);
+    defer map.deinit();
+    try std.testing.expectEqual(@as(usize, 2), try map.count());
+    const first = try map.entry(0);
+    var first_arr = first.array;
+    defer first_arr.deinit();
+    try std.testing.expectEqualStrings("b", first.name);
+
+    var loaded = (try map.get("w")).?;
+    defer loaded.deinit();
+    const shape = try loaded.shape(allocator);
+    defer allocator.free(shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 3 }, shape);
+    const data = try loaded.allocData(f32, allocator);
+    defer allocator.free(data);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3, 4, 5, 6 }, data);
+    try std.testing.expect(try map.get("missing") == null);
+}
+
+test "IO -> npy round trip" {
+    const allocator = std.testing.allocator;
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const path = try std.fmt.allocPrintZ(allocator, "zig-cache/tmp/{s}/array.npy", .{tmp.sub_path});
+    defer allocator.free(path);
+
+    var arr = try Array.fromSlice(f32, &.{ 1, 2, 3, 4 }, &.{ 2, 2 }, mlx.float32);
+    defer arr.deinit();
+    try saveNpy(path, arr);
+    var loaded = try loadNpy(path);
+    defer loaded.deinit();
+    const data = try loaded.allocData(f32, allocator);
+    defer allocator.free(data);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3, 4 }, data);
+}
@@ -0,0 +1,92 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+/// Bytes currently held by live MLX arrays.
+pub fn activeMemory() !usize {
+    var res: usize = undefined;
+    try mlx.MLX_CHECK(mlx.get_active_memory(&res), @src());
+    return res;
+}
+
+/// Highest value `activeMemory` has reached since start-up or the last
+/// `resetPeakMemory`.
+pub fn peakMemory() !usize {
+    var res: usize = undefined;
+    try mlx.MLX_CHECK(mlx.get_peak_memory(&res), @src());
+    return res;
+}
+
+/// Bytes held in MLX's buffer cache for reuse, not owned by any array.
+pub fn cacheMemory() !usize {
+    var res: usize = undefined;
+    try mlx.MLX_CHECK(mlx.get_cache_memory(&res), @src());
+    return res;
+}
+
+pub fn resetPeakMemory() !void {
+    return mlx.MLX_CHECK(mlx.reset_peak_memory(), @src());
+}
+
+/// Sets the allocation limit MLX tries to stay under (it waits on in-flight
+/// work before exceeding it). Returns the previous limit.
+pub fn setMemoryLimit(limit: usize) !usize {
+    var res: usize = undefined;
+    try mlx.MLX_CHECK(mlx.set_memory_limit(&res, limit), @src());
+    return res;
+}
+
+/// Caps the size of MLX's buffer cache; `0` disables caching. Returns the
+/// previous limit.
+pub fn setCacheLimit(limit: usize) !usize {
+    var res: usize = undefined;
+    try mlx.MLX_CHECK(mlx.set_cache_limit(&res, limit), @src());
+    return res;
+}
+
+/// Releases every buffer held in MLX's buffer cache.
+pub fn clearCache() !void {
+    return mlx.MLX_CHECK(mlx.clear_cache(), @src());
+}
+
+/// Point-in-time view of MLX's memory usage, e.g. taken once per training
+/// step to tune batch size against a memory budget.
+pub const Snapshot = struct {
+    active: usize,
+    peak: usize,
+    cache: usize,
+
+    pub fn take() !Snapshot {
+        return .{
+            .active = try activeMemory(),
+            .peak = try peakMemory(),
+            .cache = try cacheMemory(),
+        };
+    }
+
+    /// Active plus cached bytes, i.e. what MLX holds from the host.
+    pub fn total(self: Snapshot) usize {
+        return self.active + self.cache;
+    }
+};
+
+test "Memory -> Snapshot" {
+    try resetPeakMemory();
+    const before = try Snapshot.take();
+    var arr = try Array.initHandle(&.{ 256, 1024 }, mlx.float32);
+    const nbytes = try arr.nbytes();
+    const during = try Snapshot.take();
+    try std.testing.expect(during.active >= before.active + nbytes);
+    try std.testing.expect(during.peak >= during.active);
+    arr.deinit();
+    const after = try Snapshot.take();
+    try std.testing.expect(after.active + nbytes <= during.active);
+}
+
+test "Memory -> setCacheLimit" {
+    const prev = try setCacheLimit(0);
+    defer _ = setCacheLimit(prev) catch {};
+    try clearCache();
+    try std.testing.expectEqual(@as(usize, 0), try cacheMemory());
+}
@@ -7,22 +7,80 @@ const mlx = @cImport({
 pub usingnamespace mlx;
 pub usingnamespace @import("array.zig");
 pub const ops = @import("ops.zig");
+pub const memory = @import("memory.zig");
+pub const io = @import("io.zig");
+pub const compile = @import("compile.zig");
+pub const graph = @import("graph.zig");
+pub const profile = @import("profile.zig");
+pub const Stream = @import("stream.zig").Stream;
 
-pub inline fn MLX_CHECK(v: mlx.mlx_err, src: std.builtin.SourceLocation) !void {
-    if (v != mlx.mlx_success) {
-        std.debug.print("MLX Exception - {s}:{d}\n", .{ src.file, src.line });
-        return error.MLXThrewException;
-    }
+/// Typed errors corresponding to the `mlx_err` codes returned by the bindings.
+pub const Error = error{
+    MLXThrewException,
+    MLXInvalidArgument,
+    MLXOutOfRange,
+    MLXOutOfMemory,
+    MLXRuntimeError,
+    MLXUnknownError,
+};
+
+/// Maps an `mlx_err` to a typed error. Details of the failure are available
+/// from `lastError` on the same thread.
+pub inline fn MLX_CHECK(v: mlx.mlx_err, src: std.builtin.SourceLocation) Error!void {
+    _ = src;
+    return switch (v) {
+        mlx.mlx_success => {},
+        mlx.mlx_invalid_argument => error.MLXInvalidArgument,
+        mlx.mlx_out_of_range => error.MLXOutOfRange,
+        mlx.mlx_out_of_memory => error.MLXOutOfMemory,
+        mlx.mlx_runtime_error => error.MLXRuntimeError,
+        mlx.mlx_unknown_error => error.MLXUnknownError,
+        else => error.MLXThrewException,
+    };
+}
+
+/// Details of the most recent failed MLX call on the current thread.
+pub const LastError = struct {
+    code: mlx.mlx_err,
+    /// Name of the binding that failed.
+    op: []const u8,
+    /// Message of the underlying C++ exception.
+    message: []const u8,
+};
+
+/// Returns the most recent failure on the current thread. The slices are only
+/// valid until the next failing MLX call on the same thread.
+pub fn lastError() LastError {
+    var info: mlx.mlx_error_info = undefined;
+    mlx.mlx_last_error(&info);
+    return .{ .code = info.code, .op = std.mem.span(info.op), .message = std.mem.span(info.message) };
 }
 
 test {
+    _ = @import("array.zig");
     _ = ops;
+    _ = memory;
+    _ = io;
+    _ = compile;
+    _ = graph;
+    _ = profile;
+    _ = @import("stream.zig");
 }
 
 test "MLX -> seed" {
     try MLX_CHECK(mlx.seed(12345), @src());
 }
 
+test "MLX -> lastError" {
+    mlx.mlx_clear_error();
+    var arr: mlx.mlx_array = null;
+    try std.testing.expectError(error.MLXInvalidArgument, MLX_CHECK(mlx.fromScalar(&arr, 1, 99), @src()));
+    const err = lastError();
+    try std.testing.expect(err.code == mlx.mlx_invalid_argument);
+    try std.testing.expectEqualStrings("fromScalar", err.op);
+    try std.testing.expectEqualStrings("Invalid dtype enum", err.message);
+}
+
 test "MLX -> randomNormal" {
     const shape: []const c_int = &.{ 4, 4, 4 };
     var arr: mlx.mlx_array = null;
@@ -3,24 +3,34 @@ const std = @import("std");
 
 const Array = mlx.Array;
 
-const OperatorLoc = enum { Lhs, Rhs };
+const OperatorLoc = enum {
+    Lhs,
+    Rhs,
 
-fn createTmpScalar(comptime T: type, val: T, dtype: mlx.mlx_dtype, comptime fn_name: [:0]const u8, comptime side: OperatorLoc) !Array {
-    const TypeInfo = @typeInfo(T);
-    if (TypeInfo != .Int and TypeInfo != .Float) {
-        @compileError(fn_name ++ ": Invalid Type passed for " ++ @tagName(side));
+    fn side(self: OperatorLoc) mlx.mlx_operator_side {
+        return switch (self) {
+            .Lhs => mlx.mlx_lhs,
+            .Rhs => mlx.mlx_rhs,
+        };
     }
-    var res: mlx.mlx_array = null;
-    if (TypeInfo == .Int) {
-        switch (T) {
-            .u64 => try mlx.MLX_CHECK(mlx.fromScalarU64(&res, val), @src()),
-            .i64 => try mlx.MLX_CHECK(mlx.fromScalarI64(&res, val), @src()),
-            else => try mlx.MLX_CHECK(mlx.fromScalar(&res, @floatFromInt(val), dtype), @src()),
-        }
-    } else if (TypeInfo == .Float) {
-        try mlx.MLX_CHECK(mlx.fromScalar(&res, @floatCast(val), dtype), @src());
-    }
-    return Array.init(res);
+};
+
+/// Converts a scalar operand to the `mlx_scalar` passed to the `*_scalar`
+/// bindings. Integers keep their exact 64-bit value.
+fn scalarValue(comptime T: type, val: T, comptime fn_name: [:0]const u8, comptime side: OperatorLoc) mlx.mlx_scalar {
+    return switch (@typeInfo(T)) {
+        .Int => |info| if (info.signedness == .signed)
+            .{ .kind = mlx.mlx_scalar_int, .val = .{ .i = @intCast(val) } }
+        else
+            .{ .kind = mlx.mlx_scalar_uint, .val = .{ .u = @intCast(val) } },
+        .Float => .{ .kind = mlx.mlx_scalar_float, .val = .{ .f = @floatCast(val) } },
+        else => @compileError(fn_name ++ ": Invalid Type passed for " ++ @tagName(side)),
+    };
+}
+
+/// Whether `T` is an array operand of a `*Consume` op (`*Array` is consumed).
+fn isArrayOperand(comptime T: type) bool {
+    return T == Array or T == *Array;
 }
 
 pub fn add(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Array {
@@ -32,13 +42,11 @@ pub fn add(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Arra
     if (LhsT == Array and RhsT == Array) {
         try mlx.MLX_CHECK(mlx.add(&res, lhs.handle, rhs.handle), @src());
     } else if (LhsT == Array) {
-        var tmp = try createTmpScalar(RhsT, rhs, try lhs.dtype(), fn_name, .Rhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.add(&res, lhs.handle, tmp.handle), @src());
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.add_scalar(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
     } else {
-        var tmp = try createTmpScalar(LhsT, lhs, try rhs.dtype(), fn_name, .Lhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.add(&res, tmp.handle, rhs.handle), @src());
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.add_scalar(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
     }
     return Array.init(res);
 }
@@ -52,13 +60,11 @@ pub fn subtract(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT)
     if (LhsT == Array and RhsT == Array) {
         try mlx.MLX_CHECK(mlx.subtract(&res, lhs.handle, rhs.handle), @src());
     } else if (LhsT == Array) {
-        var tmp = try createTmpScalar(RhsT, rhs, try lhs.dtype(), fn_name, .Rhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.subtract(&res, lhs.handle, tmp.handle), @src());
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
     } else {
-        var tmp = try createTmpScalar(LhsT, lhs, try rhs.dtype(), fn_name, .Lhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.subtract(&res, tmp.handle, rhs.handle), @src());
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
     }
     return Array.init(res);
 }
@@ -72,13 +78,11 @@ pub fn multiply(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT)
     if (LhsT == Array and RhsT == Array) {
         try mlx.MLX_CHECK(mlx.multiply(&res, lhs.handle, rhs.handle), @src());
     } else if (LhsT == Array) {
-        var tmp = try createTmpScalar(RhsT, rhs, try lhs.dtype(), fn_name, .Rhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.multiply(&res, lhs.handle, tmp.handle), @src());
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
     } else {
-        var tmp = try createTmpScalar(LhsT, lhs, try rhs.dtype(), fn_name, .Lhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.multiply(&res, tmp.handle, rhs.handle), @src());
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
     }
     return Array.init(res);
 }
@@ -92,14 +96,428 @@ pub fn divide(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !A
     if (LhsT == Array and RhsT == Array) {
         try mlx.MLX_CHECK(mlx.divide(&res, lhs.handle, rhs.handle), @src());
     } else if (LhsT == Array) {
-        var tmp = try createTmpScalar(RhsT, rhs, try lhs.dtype(), fn_name, .Rhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.divide(&res, lhs.handle, tmp.handle), @src());
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    }
+    return Array.init(res);
+}
+
+/// Like `add`, but assigns the result to `out` instead of returning a new
+/// handle (`out` may alias an operand). An `out` without a handle gets one.
+pub fn addInto(out: *Array, comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !void {
+    if (out.handle == null) {
+        out.* = try add(LhsT, lhs, RhsT, rhs);
+        return;
+    }
+    if (LhsT != Array and RhsT != Array) {
+        @compileError("addInto: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    if (LhsT == Array and RhsT == Array) {
+        try mlx.MLX_CHECK(mlx.add_into(out.handle, lhs.handle, rhs.handle), @src());
+    } else if (LhsT == Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.add_scalar_into(out.handle, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
     } else {
-        var tmp = try createTmpScalar(LhsT, lhs, try rhs.dtype(), fn_name, .Lhs);
-        defer tmp.deinit();
-        try mlx.MLX_CHECK(mlx.divide(&res, tmp.handle, rhs.handle), @src());
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.add_scalar_into(out.handle, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    }
+}
+
+/// Like `subtract`, but assigns the result to `out` instead of returning a new
+/// handle (`out` may alias an operand). An `out` without a handle gets one.
+pub fn subtractInto(out: *Array, comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !void {
+    if (out.handle == null) {
+        out.* = try subtract(LhsT, lhs, RhsT, rhs);
+        return;
+    }
+    if (LhsT != Array and RhsT != Array) {
+        @compileError("subtractInto: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    if (LhsT == Array and RhsT == Array) {
+        try mlx.MLX_CHECK(mlx.subtract_into(out.handle, lhs.handle, rhs.handle), @src());
+    } else if (LhsT == Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar_into(out.handle, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar_into(out.handle, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    }
+}
+
+/// Like `multiply`, but assigns the result to `out` instead of returning a new
+/// handle (`out` may alias an operand). An `out` without a handle gets one.
+pub fn multiplyInto(out: *Array, comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !void {
+    if (out.handle == null) {
+        out.* = try multiply(LhsT, lhs, RhsT, rhs);
+        return;
+    }
+    if (LhsT != Array and RhsT != Array) {
+        @compileError("multiplyInto: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    if (LhsT == Array and RhsT == Array) {
+        try mlx.MLX_CHECK(mlx.multiply_into(out.handle, lhs.handle, rhs.handle), @src());
+    } else if (LhsT == Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar_into(out.handle, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar_into(out.handle, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    }
+}
+
+/// Like `divide`, but assigns the result to `out` instead of returning a new
+/// handle (`out` may alias an operand). An `out` without a handle gets one.
+pub fn divideInto(out: *Array, comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !void {
+    if (out.handle == null) {
+        out.* = try divide(LhsT, lhs, RhsT, rhs);
+        return;
+    }
+    if (LhsT != Array and RhsT != Array) {
+        @compileError("divideInto: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    if (LhsT == Array and RhsT == Array) {
+        try mlx.MLX_CHECK(mlx.divide_into(out.handle, lhs.handle, rhs.handle), @src());
+    } else if (LhsT == Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar_into(out.handle, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar_into(out.handle, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    }
+}
+
+/// Like `add`, but an operand passed as `*Array` is consumed: its handle is
+/// released once the result exists (and set to null), so MLX may donate its
+/// buffer to the output. Arena-backed and inline operands are emptied rather
+/// than released. Operands passed as `Array` are only borrowed.
+pub fn addConsume(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Array {
+    if (!isArrayOperand(LhsT) and !isArrayOperand(RhsT)) {
+        @compileError("addConsume: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    var res: mlx.mlx_array = null;
+    if (isArrayOperand(LhsT) and isArrayOperand(RhsT)) {
+        try mlx.MLX_CHECK(mlx.add_consume(&res, lhs.handle, rhs.handle, LhsT == *Array, RhsT == *Array), @src());
+    } else if (LhsT == *Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.add_scalar_consume(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else if (RhsT == *Array) {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.add_scalar_consume(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    } else {
+        return add(LhsT, lhs, RhsT, rhs);
+    }
+    if (LhsT == *Array) lhs.handle = null;
+    if (RhsT == *Array) rhs.handle = null;
+    return Array.init(res);
+}
+
+/// Like `subtract`, but an operand passed as `*Array` is consumed: its handle is
+/// released once the result exists (and set to null), so MLX may donate its
+/// buffer to the output. Arena-backed and inline operands are emptied rather
+/// than released. Operands passed as `Array` are only borrowed.
+pub fn subtractConsume(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Array {
+    if (!isArrayOperand(LhsT) and !isArrayOperand(RhsT)) {
+        @compileError("subtractConsume: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    var res: mlx.mlx_array = null;
+    if (isArrayOperand(LhsT) and isArrayOperand(RhsT)) {
+        try mlx.MLX_CHECK(mlx.subtract_consume(&res, lhs.handle, rhs.handle, LhsT == *Array, RhsT == *Array), @src());
+    } else if (LhsT == *Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar_consume(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else if (RhsT == *Array) {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.subtract_scalar_consume(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    } else {
+        return subtract(LhsT, lhs, RhsT, rhs);
+    }
+    if (LhsT == *Array) lhs.handle = null;
+    if (RhsT == *Array) rhs.handle = null;
+    return Array.init(res);
+}
+
+/// Like `multiply`, but an operand passed as `*Array` is consumed: its handle is
+/// released once the result exists (and set to null), so MLX may donate its
+/// buffer to the output. Arena-backed and inline operands are emptied rather
+/// than released. Operands passed as `Array` are only borrowed.
+pub fn multiplyConsume(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Array {
+    if (!isArrayOperand(LhsT) and !isArrayOperand(RhsT)) {
+        @compileError("multiplyConsume: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    var res: mlx.mlx_array = null;
+    if (isArrayOperand(LhsT) and isArrayOperand(RhsT)) {
+        try mlx.MLX_CHECK(mlx.multiply_consume(&res, lhs.handle, rhs.handle, LhsT == *Array, RhsT == *Array), @src());
+    } else if (LhsT == *Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar_consume(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else if (RhsT == *Array) {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.multiply_scalar_consume(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    } else {
+        return multiply(LhsT, lhs, RhsT, rhs);
+    }
+    if (LhsT == *Array) lhs.handle = null;
+    if (RhsT == *Array) rhs.handle = null;
+    return Array.init(res);
+}
+
+/// Like `divide`, but an operand passed as `*Array` is consumed: its handle is
+/// released once the result exists (and set to null), so MLX may donate its
+/// buffer to the output. Arena-backed and inline operands are emptied rather
+/// than released. Operands passed as `Array` are only borrowed.
+pub fn divideConsume(comptime LhsT: type, lhs: LhsT, comptime RhsT: type, rhs: RhsT) !Array {
+    if (!isArrayOperand(LhsT) and !isArrayOperand(RhsT)) {
+        @compileError("divideConsume: at least one of the arguments must be an Array");
+    }
+    const fn_name = @src().fn_name;
+    var res: mlx.mlx_array = null;
+    if (isArrayOperand(LhsT) and isArrayOperand(RhsT)) {
+        try mlx.MLX_CHECK(mlx.divide_consume(&res, lhs.handle, rhs.handle, LhsT == *Array, RhsT == *Array), @src());
+    } else if (LhsT == *Array) {
+        const val = scalarValue(RhsT, rhs, fn_name, .Rhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar_consume(&res, lhs.handle, val, OperatorLoc.Rhs.side()), @src());
+    } else if (RhsT == *Array) {
+        const val = scalarValue(LhsT, lhs, fn_name, .Lhs);
+        try mlx.MLX_CHECK(mlx.divide_scalar_consume(&res, rhs.handle, val, OperatorLoc.Lhs.side()), @src());
+    } else {
+        return divide(LhsT, lhs, RhsT, rhs);
+    }
+    if (LhsT == *Array) lhs.handle = null;
+    if (RhsT == *Array) rhs.handle = null;
+    return Array.init(res);
+}
+
+/// Returns the view `arr[start:stop:strides]` (one entry per dimension; null
+/// `strides` means unit strides), sharing `arr`'s buffer.
+pub fn slice(arr: Array, start: []const i64, stop: []const i64, strides: ?[]const i64) !Array {
+    if (start.len != stop.len or (strides != null and strides.?.len != start.len)) return error.SizeMismatch;
+    var start_buf: [mlx.max_dims]c_int = undefined;
+    var stop_buf: [mlx.max_dims]c_int = undefined;
+    var strides_buf: [mlx.max_dims]c_int = undefined;
+    const c_start = try mlx.cShape(start, &start_buf);
+    const c_stop = try mlx.cShape(stop, &stop_buf);
+    const c_strides = if (strides) |st| try mlx.cShape(st, &strides_buf) else blk: {
+        @memset(strides_buf[0..start.len], 1);
+        break :blk strides_buf[0..start.len];
+    };
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.slice(&res, arr.handle, c_start.ptr, c_stop.ptr, c_strides.ptr, c_start.len), @src());
+    return Array.init(res);
+}
+
+/// Returns `arr` with the given shape (one entry may be -1 to infer it). The
+/// result is a view unless `arr`'s layout forces MLX to copy.
+pub fn reshape(arr: Array, shape: []const i64) !Array {
+    var shape_buf: [mlx.max_dims]c_int = undefined;
+    const c_shape = try mlx.cShape(shape, &shape_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.reshape(&res, arr.handle, c_shape.ptr, c_shape.len), @src());
+    return Array.init(res);
+}
+
+/// Returns a view of `arr` with its axes permuted; an empty `axes` reverses
+/// them.
+pub fn transpose(arr: Array, axes: []const i64) !Array {
+    var axes_buf: [mlx.max_dims]c_int = undefined;
+    const c_axes = try mlx.cShape(axes, &axes_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.transpose(&res, arr.handle, c_axes.ptr, c_axes.len), @src());
+    return Array.init(res);
+}
+
+/// Returns a view of `arr` with size-1 axes inserted at `axes`.
+pub fn expandDims(arr: Array, axes: []const i64) !Array {
+    var axes_buf: [mlx.max_dims]c_int = undefined;
+    const c_axes = try mlx.cShape(axes, &axes_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.expand_dims(&res, arr.handle, c_axes.ptr, c_axes.len), @src());
+    return Array.init(res);
+}
+
+/// Returns a view of `arr` without the size-1 `axes`; an empty `axes` drops
+/// every size-1 axis.
+pub fn squeeze(arr: Array, axes: []const i64) !Array {
+    var axes_buf: [mlx.max_dims]c_int = undefined;
+    const c_axes = try mlx.cShape(axes, &axes_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.squeeze(&res, arr.handle, c_axes.ptr, c_axes.len), @src());
+    return Array.init(res);
+}
+
+/// Returns a view of `arr` broadcast to `shape` (broadcast axes get stride 0).
+pub fn broadcastTo(arr: Array, shape: []const i64) !Array {
+    var shape_buf: [mlx.max_dims]c_int = undefined;
+    const c_shape = try mlx.cShape(shape, &shape_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.broadcast_to(&res, arr.handle, c_shape.ptr, c_shape.len), @src());
+    return Array.init(res);
+}
+
+/// Returns a view over `arr`'s buffer with arbitrary `shape` and `strides`
+/// (in elements), starting `offset` elements in. Nothing checks that the view
+/// stays inside the buffer.
+pub fn asStrided(arr: Array, shape: []const i64, strides: []const i64, offset: usize) !Array {
+    if (shape.len != strides.len) return error.SizeMismatch;
+    var shape_buf: [mlx.max_dims]c_int = undefined;
+    const c_shape = try mlx.cShape(shape, &shape_buf);
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.as_strided(&res, arr.handle, c_shape.ptr, strides.ptr, c_shape.len, offset), @src());
+    return Array.init(res);
+}
+
+/// Joins `arrays` along the existing `axis` in a single binding call.
+pub fn concatenate(arrays: []const Array, axis: i64) !Array {
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.concatenate(&res, @ptrCast(arrays.ptr), arrays.len, @intCast(axis)), @src());
+    return Array.init(res);
+}
+
+/// Stacks `arrays` along a new `axis` in a single binding call, e.g. to build
+/// a minibatch from per-sample arrays.
+pub fn stack(arrays: []const Array, axis: i64) !Array {
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.stack(&res, @ptrCast(arrays.ptr), arrays.len, @intCast(axis)), @src());
+    return Array.init(res);
+}
+
+pub const BinaryOp = enum {
+    add,
+    subtract,
+    multiply,
+    divide,
+
+    fn cOp(self: BinaryOp) mlx.mlx_binary_op {
+        return switch (self) {
+            .add => mlx.mlx_op_add,
+            .subtract => mlx.mlx_op_subtract,
+            .multiply => mlx.mlx_op_multiply,
+            .divide => mlx.mlx_op_divide,
+        };
     }
+};
+
+/// Operand of a batched op: an array, the result of an earlier op in the same
+/// batch, or a scalar (promoted like the scalar operands of `add` etc.).
+pub const Operand = union(enum) {
+    array: Array,
+    result: usize,
+    float: f64,
+    int: i64,
+
+    fn cOperand(self: Operand) mlx.mlx_operand {
+        return switch (self) {
+            .array => |a| .{ .arr = a.handle, .result = -1, .val = std.mem.zeroes(mlx.mlx_scalar) },
+            .result => |idx| .{ .arr = null, .result = @intCast(idx), .val = std.mem.zeroes(mlx.mlx_scalar) },
+            .float => |v| .{ .arr = null, .result = -1, .val = scalarValue(f64, v, "dispatchBatch", .Rhs) },
+            .int => |v| .{ .arr = null, .result = -1, .val = scalarValue(i64, v, "dispatchBatch", .Rhs) },
+        };
+    }
+};
+
+pub const OpDesc = struct {
+    op: BinaryOp,
+    lhs: Operand,
+    rhs: Operand,
+};
+
+/// Runs every op in `descs` in a single binding call, returning one result
+/// per op; with `eval_results` set they are also evaluated together.
+///
+/// The caller owns the returned arrays; release them with `deinitSlice`.
+pub fn dispatchBatch(allocator: std.mem.Allocator, descs: []const OpDesc, eval_results: bool) ![]Array {
+    const c_descs = try allocator.alloc(mlx.mlx_op_desc, descs.len);
+    defer allocator.free(c_descs);
+    for (descs, c_descs) |desc, *c_desc| {
+        c_desc.* = .{ .op = desc.op.cOp(), .lhs = desc.lhs.cOperand(), .rhs = desc.rhs.cOperand() };
+    }
+    const res = try allocator.alloc(Array, descs.len);
+    errdefer allocator.free(res);
+    try mlx.MLX_CHECK(mlx.dispatch_batch(@ptrCast(res.ptr), c_descs.ptr, c_descs.len, eval_results), @src());
+    return res;
+}
+
+/// A weight matrix quantized with `quantize`: the packed weight together with
+/// the per-group scales and biases and the parameters needed to use them.
+pub const QuantizedWeight = struct {
+    /// `bits`-bit values packed into `uint32`, `32 / bits` per element.
+    weight: Array,
+    scales: Array,
+    biases: Array,
+    group_size: i32,
+    bits: i32,
+
+    pub fn deinit(self: *QuantizedWeight) void {
+        self.weight.deinit();
+        self.scales.deinit();
+        self.biases.deinit();
+    }
+
+    /// Reconstructs the full-precision weight.
+    pub fn dequantize(self: *const QuantizedWeight) !Array {
+        var res: mlx.mlx_array = null;
+        try mlx.MLX_CHECK(mlx.dequantize(&res, self.weight.handle, self.scales.handle, self.biases.handle, self.group_size, self.bits), @src());
+        return Array.init(res);
+    }
+};
+
+/// Quantizes the last axis of `w` (divisible by `group_size`) to `bits`-bit
+/// values with one scale and bias per group. MLX supports group sizes of 32,
+/// 64 and 128 and 2, 4 or 8 bits.
+pub fn quantize(w: Array, group_size: i32, bits: i32) !QuantizedWeight {
+    var weight: mlx.mlx_array = null;
+    var scales: mlx.mlx_array = null;
+    var biases: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.quantize(&weight, &scales, &biases, w.handle, group_size, bits), @src());
+    return .{
+        .weight = Array.init(weight),
+        .scales = Array.init(scales),
+        .biases = Array.init(biases),
+        .group_size = group_size,
+        .bits = bits,
+    };
+}
+
+/// Multiplies `x` by the quantized weight without dequantizing it: computes
+/// `x @ w.T` when `transpose` is set (the layout of linear layers), else
+/// `x @ w`.
+pub fn quantizedMatmul(x: Array, w: QuantizedWeight, transpose: bool) !Array {
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.quantized_matmul(&res, x.handle, w.weight.handle, w.scales.handle, w.biases.handle, transpose, w.group_size, w.bits), @src());
+    return Array.init(res);
+}
+
+/// Matrix product over the last two axes of `a` and `b`; leading batch axes
+/// broadcast against each other, so a `[B, M, K]` batch can be multiplied by a
+/// single `[K, N]` matrix.
+pub fn matmul(a: Array, b: Array) !Array {
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.matmul(&res, a.handle, b.handle), @src());
+    return Array.init(res);
+}
+
+/// Computes `alpha * (a @ b) + beta * c` as a single fused GEMM.
+pub fn addmm(c: Array, a: Array, b: Array, alpha: f32, beta: f32) !Array {
+    var res: mlx.mlx_array = null;
+    try mlx.MLX_CHECK(mlx.addmm(&res, c.handle, a.handle, b.handle, alpha, beta), @src());
+    return Array.init(res);
+}
+
+/// Linear layer `x @ w.T + b` for a `[out, in]` weight, without materializing
+/// the transposed weight or the broadcast bias.
+pub fn linear(x: Array, w: Array, b: ?Array) !Array {
+    var res: mlx.mlx_array = null;
+    const bias: mlx.mlx_array = if (b) |arr| arr.handle else null;
+    try mlx.MLX_CHECK(mlx.linear(&res, x.handle, w.handle, bias), @src());
     return Array.init(res);
 }
 
@@ -150,3 +568,225 @@ test "Ops -> subtract" {
     const e_data = try e.data(f32);
     try std.testing.expectEqualSlices(f32, e_data, &.{ 2, 1, 0, -1, -2, -3, -4, -5, -6, -7 });
 }
+
+test "Ops -> scalar promotion" {
+    var a = try Array.fromSlice(i32, &.{ 1, 2, 3, 4 }, &.{4}, mlx.int32);
+    defer a.deinit();
+    var b = try multiply(Array, a, f32, 0.5);
+    defer b.deinit();
+    try std.testing.expect(try b.dtype() == mlx.float32);
+    try b.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 0.5, 1, 1.5, 2 }, try b.data(f32));
+
+    var c = try multiply(i32, 2, Array, a);
+    defer c.deinit();
+    try std.testing.expect(try c.dtype() == mlx.int32);
+    try c.eval(false);
+    try std.testing.expectEqualSlices(i32, &.{ 2, 4, 6, 8 }, try c.data(i32));
+}
+
+test "Ops -> int64 scalar" {
+    const big: i64 = (1 << 60) + 1;
+    var a = try Array.fromSlice(i64, &.{ 1, 2 }, &.{2}, mlx.int64);
+    defer a.deinit();
+    var b = try add(Array, a, i64, big);
+    defer b.deinit();
+    try b.eval(false);
+    try std.testing.expectEqualSlices(i64, &.{ big + 1, big + 2 }, try b.data(i64));
+}
+
+test "Ops -> subtractInto" {
+    var w = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer w.deinit();
+    var g = try Array.fromSlice(f32, &.{ 2, 2, 2 }, &.{3}, mlx.float32);
+    defer g.deinit();
+    var step = Array{};
+    defer step.deinit();
+    const handle = w.handle;
+    for (0..2) |_| {
+        try multiplyInto(&step, Array, g, f32, 0.5);
+        try subtractInto(&w, Array, w, Array, step);
+        try w.eval(false);
+    }
+    try std.testing.expect(w.handle == handle);
+    try std.testing.expectEqualSlices(f32, &.{ -1, 0, 1 }, try w.data(f32));
+}
+
+test "Ops -> addConsume" {
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer x.deinit();
+    var b = try Array.fromSlice(f32, &.{ 1, 1, 1 }, &.{3}, mlx.float32);
+    defer b.deinit();
+    var y = try addConsume(*Array, &x, f32, 1);
+    defer y.deinit();
+    try std.testing.expect(x.handle == null);
+    var z = try multiplyConsume(*Array, &y, Array, b);
+    defer z.deinit();
+    try std.testing.expect(y.handle == null);
+    try std.testing.expect(b.handle != null);
+    try z.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 4 }, try z.data(f32));
+}
+
+test "Ops -> consuming inline storage" {
+    var x = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    var slot = try mlx.InlineArray.initTake(&x);
+    // the storage is emptied, not freed; it is still released with deinit
+    defer slot.deinit();
+    var operand = slot.array();
+    var y = try addConsume(*Array, &operand, f32, 1);
+    defer y.deinit();
+    try std.testing.expect(operand.handle == null);
+    try y.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 4 }, try y.data(f32));
+}
+
+test "Ops -> quantize" {
+    const allocator = std.testing.allocator;
+    var values: [2 * 64]f32 = undefined;
+    for (&values, 0..) |*v, i| v.* = @as(f32, @floatFromInt(i % 64)) / 64;
+    var w = try Array.fromSlice(f32, &values, &.{ 2, 64 }, mlx.float32);
+    defer w.deinit();
+
+    var qw = try quantize(w, 64, 4);
+    defer qw.deinit();
+    const packed_shape = try qw.weight.shape(allocator);
+    defer allocator.free(packed_shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 8 }, packed_shape);
+
+    var deq = try qw.dequantize();
+    defer deq.deinit();
+    try deq.eval(false);
+    for (try deq.data(f32), values) |got, want| {
+        try std.testing.expectApproxEqAbs(want, got, 1.0 / 30.0);
+    }
+
+    var x = try Array.fromSlice(f32, &([_]f32{1} ** 64), &.{ 1, 64 }, mlx.float32);
+    defer x.deinit();
+    var y = try quantizedMatmul(x, qw, true);
+    defer y.deinit();
+    try y.eval(false);
+    const out = try y.data(f32);
+    try std.testing.expectEqual(@as(usize, 2), out.len);
+    try std.testing.expectApproxEqAbs(@as(f32, 31.5), out[0], 1);
+}
+
+test "Ops -> views" {
+    const allocator = std.testing.allocator;
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3, 4, 5, 6 }, &.{ 2, 3 }, mlx.float32);
+    defer a.deinit();
+
+    var t = try transpose(a, &.{});
+    defer t.deinit();
+    try t.eval(false);
+    const t_flags = try t.flags();
+    try std.testing.expect(!t_flags.row_contiguous and t_flags.col_contiguous);
+    try std.testing.expect((try t.data(f32)).ptr == (try a.data(f32)).ptr);
+    var t_data: [6]f32 = undefined;
+    try t.copyTo(f32, &t_data, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 4, 2, 5, 3, 6 }, &t_data);
+
+    var col = try slice(a, &.{ 0, 1 }, &.{ 2, 2 }, null);
+    defer col.deinit();
+    var col_data: [2]f32 = undefined;
+    try col.copyTo(f32, &col_data, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 5 }, &col_data);
+
+    var r = try reshape(a, &.{ 3, -1 });
+    defer r.deinit();
+    var e = try expandDims(r, &.{0});
+    defer e.deinit();
+    var sq = try squeeze(e, &.{});
+    defer sq.deinit();
+    const sq_shape = try sq.shape(allocator);
+    defer allocator.free(sq_shape);
+    try std.testing.expectEqualSlices(i64, &.{ 3, 2 }, sq_shape);
+
+    var b = try broadcastTo(col, &.{ 3, 2, 1 });
+    defer b.deinit();
+    var b_data: [6]f32 = undefined;
+    try b.copyTo(f32, &b_data, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 5, 2, 5, 2, 5 }, &b_data);
+
+    var s = try asStrided(a, &.{ 2, 2 }, &.{ 1, 1 }, 1);
+    defer s.deinit();
+    var s_data: [4]f32 = undefined;
+    try s.copyTo(f32, &s_data, mlx.mlx_row_major);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 3, 4 }, &s_data);
+
+    var rev = try asStrided(a, &.{3}, &.{-1}, 2);
+    defer rev.deinit();
+    try rev.eval(false);
+    const rev_strides = try rev.strides(allocator);
+    defer allocator.free(rev_strides);
+    try std.testing.expectEqualSlices(i64, &.{-1}, rev_strides);
+}
+
+test "Ops -> stack/concatenate" {
+    const allocator = std.testing.allocator;
+    var a = try Array.fromSlice(f32, &.{ 1, 2 }, &.{2}, mlx.float32);
+    defer a.deinit();
+    var b = try Array.fromSlice(f32, &.{ 3, 4 }, &.{2}, mlx.float32);
+    defer b.deinit();
+
+    var s = try stack(&.{ a, b }, 0);
+    defer s.deinit();
+    const s_shape = try s.shape(allocator);
+    defer allocator.free(s_shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 2 }, s_shape);
+
+    var c = try concatenate(&.{ a, b, a }, 0);
+    defer c.deinit();
+    try c.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 1, 2, 3, 4, 1, 2 }, try c.data(f32));
+}
+
+test "Ops -> dispatchBatch" {
+    const allocator = std.testing.allocator;
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    const res = try dispatchBatch(allocator, &.{
+        .{ .op = .add, .lhs = .{ .array = a }, .rhs = .{ .float = 1 } },
+        .{ .op = .multiply, .lhs = .{ .result = 0 }, .rhs = .{ .array = a } },
+        .{ .op = .subtract, .lhs = .{ .int = 10 }, .rhs = .{ .result = 1 } },
+    }, true);
+    defer Array.deinitSlice(allocator, res);
+    try std.testing.expectEqualSlices(f32, &.{ 2, 3, 4 }, try res[0].data(f32));
+    try std.testing.expectEqualSlices(f32, &.{ 2, 6, 12 }, try res[1].data(f32));
+    try std.testing.expectEqualSlices(f32, &.{ 8, 4, -2 }, try res[2].data(f32));
+}
+
+test "Ops -> matmul" {
+    const allocator = std.testing.allocator;
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12 }, &.{ 2, 2, 3 }, mlx.float32);
+    defer a.deinit();
+    var w = try Array.fromSlice(f32, &.{ 1, 0, 1, 0, 1, 1 }, &.{ 2, 3 }, mlx.float32);
+    defer w.deinit();
+
+    var wt = try transpose(w, &.{});
+    defer wt.deinit();
+    var batched = try matmul(a, wt);
+    defer batched.deinit();
+    const out_shape = try batched.shape(allocator);
+    defer allocator.free(out_shape);
+    try std.testing.expectEqualSlices(i64, &.{ 2, 2, 2 }, out_shape);
+    try batched.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 4, 5, 10, 11, 16, 17, 22, 23 }, try batched.data(f32));
+
+    var b = try Array.fromSlice(f32, &.{ 1, -1 }, &.{2}, mlx.float32);
+    defer b.deinit();
+    var y = try linear(a, w, b);
+    defer y.deinit();
+    try y.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 5, 4, 11, 10, 17, 16, 23, 22 }, try y.data(f32));
+
+    var no_bias = try linear(a, w, null);
+    defer no_bias.deinit();
+    try no_bias.eval(false);
+    try std.testing.expectEqualSlices(f32, try batched.data(f32), try no_bias.data(f32));
+
+    var z = try addmm(b, a, wt, 2, 0.5);
+    defer z.deinit();
+    try z.eval(false);
+    try std.testing.expectEqualSlices(f32, &.{ 8.5, 9.5, 20.5, 21.5, 32.5, 33.5, 44.5, 45.5 }, try z.data(f32));
+}
@@ -0,0 +1,103 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+/// Totals for one exported binding, collected while profiling is enabled.
+pub const Stat = struct {
+    /// Name of the binding; valid for the lifetime of the process.
+    op: []const u8,
+    calls: usize,
+    total_ns: u64,
+    max_ns: u64,
+    /// Growth in MLX's active memory across the calls.
+    bytes_allocated: usize,
+    /// Unevaluated arrays computed, for the eval bindings.
+    graph_nodes: usize,
+
+    pub fn meanNs(self: Stat) u64 {
+        return if (self.calls > 0) self.total_ns / self.calls else 0;
+    }
+};
+
+/// Turns profiling of every binding call on or off. While disabled, a binding
+/// call pays a single relaxed atomic load.
+pub fn enable(enabled: bool) void {
+    mlx.mlx_profile_enable(enabled);
+}
+
+pub fn isEnabled() bool {
+    return mlx.mlx_profile_enabled();
+}
+
+/// Drops every recorded stat and trace event.
+pub fn reset() void {
+    mlx.mlx_profile_reset();
+}
+
+/// Returns the per-binding stats in first-call order.
+///
+/// The caller owns the returned slice.
+pub fn stats(allocator: std.mem.Allocator) ![]Stat {
+    var n: usize = undefined;
+    try mlx.MLX_CHECK(mlx.mlx_profile_size(&n), @src());
+    const res = try allocator.alloc(Stat, n);
+    errdefer allocator.free(res);
+    for (res, 0..) |*stat, i| {
+        var raw: mlx.mlx_profile_stat = undefined;
+        try mlx.MLX_CHECK(mlx.mlx_profile_stat_at(&raw, i), @src());
+        stat.* = .{
+            .op = std.mem.span(raw.op),
+            .calls = raw.calls,
+            .total_ns = raw.total_ns,
+            .max_ns = raw.max_ns,
+            .bytes_allocated = raw.bytes_allocated,
+            .graph_nodes = raw.graph_nodes,
+        };
+    }
+    return res;
+}
+
+/// Writes the recorded calls as Chrome trace JSON (chrome://tracing or
+/// Perfetto), with eval calls annotated with the size of their graph. Only the
+/// latest 2^20 calls are kept; older ones are counted in
+/// `otherData.dropped_events`.
+pub fn saveTrace(path: [:0]const u8) !void {
+    return mlx.MLX_CHECK(mlx.mlx_profile_save_trace(path.ptr), @src());
+}
+
+test "Profile -> stats" {
+    const allocator = std.testing.allocator;
+    reset();
+    enable(true);
+    defer enable(false);
+    defer reset();
+
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+    var b = try mlx.ops.add(Array, a, Array, a);
+    defer b.deinit();
+    var c = try mlx.ops.multiply(Array, b, Array, b);
+    defer c.deinit();
+    try c.eval(false);
+    enable(false);
+
+    const res = try stats(allocator);
+    defer allocator.free(res);
+    var eval_stat: ?Stat = null;
+    for (res) |stat| {
+        if (std.mem.eql(u8, stat.op, "eval_array")) eval_stat = stat;
+    }
+    try std.testing.expectEqual(@as(usize, 1), eval_stat.?.calls);
+    try std.testing.expectEqual(@as(usize, 2), eval_stat.?.graph_nodes);
+
+    var tmp = std.testing.tmpDir(.{});
+    defer tmp.cleanup();
+    const path = try std.fmt.allocPrintZ(allocator, "zig-cache/tmp/{s}/trace.json", .{tmp.sub_path});
+    defer allocator.free(path);
+    try saveTrace(path);
+    const trace = try tmp.dir.readFileAlloc(allocator, "trace.json", 1 << 20);
+    defer allocator.free(trace);
+    try std.testing.expect(std.mem.startsWith(u8, trace, "{\"traceEvents\":["));
+    try std.testing.expect(std.mem.indexOf(u8, trace, "\"dropped_events\":0") != null);
+}
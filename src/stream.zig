@@ -0,0 +1,75 @@
+const std = @import("std");
+const mlx = @import("mlx.zig");
+
+const Array = mlx.Array;
+
+/// Convenience wrapper around ptr to an MLX stream.
+///
+/// Independent workloads issued on different CPU streams are scheduled
+/// separately, so e.g. each request pipeline of a server can overlap with
+/// the others across cores.
+pub const Stream = struct {
+    /// Pointer to the underlying MLX stream.
+    handle: mlx.mlx_stream = null,
+
+    /// Creates a new stream on the CPU device.
+    pub fn initCpu() !Stream {
+        var handle: mlx.mlx_stream = null;
+        try mlx.MLX_CHECK(mlx.new_cpu_stream(&handle), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Returns the current default stream of the CPU device.
+    pub fn defaultCpu() !Stream {
+        var handle: mlx.mlx_stream = null;
+        try mlx.MLX_CHECK(mlx.default_cpu_stream(&handle), @src());
+        return .{ .handle = handle };
+    }
+
+    /// Frees the handle; the MLX stream itself lives for the whole process.
+    pub fn deinit(self: *Stream) void {
+        if (self.handle != null) {
+            mlx.destroyStream(self.handle);
+            self.handle = null;
+        }
+    }
+
+    /// Makes this the default stream of its device for all threads.
+    pub fn setDefault(self: *const Stream) !void {
+        return mlx.MLX_CHECK(mlx.set_default_stream(self.handle), @src());
+    }
+
+    /// Blocks until all work scheduled on the stream has completed.
+    pub fn synchronize(self: *const Stream) !void {
+        return mlx.MLX_CHECK(mlx.synchronize(self.handle), @src());
+    }
+
+    /// Runs ops issued from the current thread on this stream until the
+    /// matching `pop`. Pushes nest.
+    pub fn push(self: *const Stream) !void {
+        return mlx.MLX_CHECK(mlx.stream_push(self.handle), @src());
+    }
+
+    /// Undoes the matching `push`; errors if this is not the innermost stream
+    /// pushed on the current thread.
+    pub fn pop(self: *const Stream) !void {
+        return mlx.MLX_CHECK(mlx.stream_pop(self.handle), @src());
+    }
+};
+
+test "Stream -> push/pop" {
+    var stream = try Stream.initCpu();
+    defer stream.deinit();
+    var a = try Array.fromSlice(f32, &.{ 1, 2, 3 }, &.{3}, mlx.float32);
+    defer a.deinit();
+
+    try stream.push();
+    var b = try mlx.ops.add(Array, a, Array, a);
+    defer b.deinit();
+    try stream.pop();
+    try std.testing.expectError(error.MLXInvalidArgument, stream.pop());
+
+    try Array.evalMany(&.{b});
+    try stream.synchronize();
+    try std.testing.expectEqualSlices(f32, &.{ 2, 4, 6 }, try b.data(f32));
+}